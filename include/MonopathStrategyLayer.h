@@ -39,10 +39,10 @@
 class MonopathStrategyLayer: public strategy_layer{
     public:
 		virtual void initialize();
-		virtual bool *get_decision(cMessage *in)=0;
+		virtual interface_t get_decision(cMessage *in)=0;
 		virtual void finish();
 		
-		virtual bool* exploit_model(long m) = 0;
+		virtual interface_t exploit_model(long m) = 0;
 
 	protected:
 		const int_f get_FIB_entry(int destination_node_index);
@@ -34,18 +34,73 @@
 //<aa>
 #include <omnetpp.h>
 #include "strategy_layer.h"
+#include "ccn_rng.h"
 
 using namespace std;
 
+class ccn_interest;
+
+/*
+ * 	Multipath forwarding engine. For each destination (target repository) it keeps the set of
+ * 	next hops of its FIB entries (all the equal-cost shortest paths) with their weights, and it
+ * 	chooses the output face through an alias table (Vose), i.e., with one uniform draw and
+ * 	O(1) operations whatever the number of next hops.
+ *
+ * 	Weights are the product of a static base weight of the face (1 by default, see base_weight)
+ * 	and, with split_adaptation, of a congestion term refreshed every split_interval seconds:
+ * 		- "pending": 1 / (1 + Interests forwarded through the face and still waiting for Data);
+ * 		  they are the Interests forwarded minus the PIT entries satisfied through the face during
+ * 		  the last two pending_timeout periods, so that Interests never answered are forgotten;
+ * 		- "rtt": 1 / (smoothed Interest-Data round trip time through the face, measured by the PIT).
+ */
 class MultipathStrategyLayer: public strategy_layer{
     public:
-		virtual void initialize();
-		virtual bool *get_decision(cMessage *in)=0;
-		virtual bool *exploit_model(long m) = 0;
-		//void finish();
+		virtual interface_t get_decision(cMessage *in);
+		virtual interface_t exploit_model(long){cout << "NOT IMPLEMENTED!" << endl; return 0;}
+		virtual void interest_satisfied(chunk_t, int face, double rtt);
 		
 	protected:
-		virtual vector<int> choose_paths(int num_paths)=0;
+		virtual void initialize();
+		virtual void finish();
+		virtual vector<int> choose_paths(int num_paths);
+		virtual int decide_target_repository(ccn_interest *interest);
+		virtual double base_weight(int){return 1;}
+
+		ccn_rng rng;		// Selection of the output gate and of the target repository.
+
+	private:
+		// Next hops towards a destination, with the alias table of their weights.
+		struct next_hop_set
+		{
+			vector<int> faces;
+			vector<double> prob;		// Probability of keeping each column of the alias table.
+			vector<uint32_t> alias;
+			simtime_t updated;			// Last refresh of the weights.
+		};
+
+		// Congestion state of a face.
+		struct face_state
+		{
+			unsigned long forwarded[2];	// Interests forwarded during the current and the previous period.
+			unsigned long satisfied[2];	// PIT entries satisfied during the current and the previous period.
+			double rtt;					// Smoothed round trip time [s] (0 = no sample yet).
+		};
+
+		enum {ADAPT_NONE, ADAPT_PENDING, ADAPT_RTT};
+
+		int adaptation;
+		double split_interval;
+		double pending_timeout;		// Length of a period of the pending counters [s].
+		simtime_t period_start;
+
+		boost::unordered_map<int, next_hop_set> next_hops;		// Per destination node.
+		vector<face_state> face_states;
+
+		next_hop_set &get_next_hops(int destination);
+		void update_weights(next_hop_set &);
+		int choose_face(const next_hop_set &);
+		void new_period();
+		unsigned long pending(const face_state &) const;
 };
 //</aa>
 #endif
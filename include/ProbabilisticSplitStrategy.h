@@ -38,25 +38,19 @@
 
 using namespace std;
 
-class ccn_interest;
-
+/*
+ * 	Multipath forwarding with static split factors: the base weight of each face is its split
+ * 	factor (restricted to the next hops of the FIB entries, i.e., conditioned on them).
+ */
 class ProbabilisticSplitStrategy: public MultipathStrategyLayer
 {
-    public:
-		bool* get_decision(cMessage *);
-		bool *exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl;}
-
 	protected:
 		void initialize();
-		bool* exploit(ccn_interest *);
 		void finish();
-		vector<int> choose_paths(int num_paths);
+		double base_weight(int face){return split_factors[face];}
 
 	private:
-		int decide_target_repository(ccn_interest *interest);
-		int decide_out_gate(vector<int_f> FIB_entries);
 		vector<double> split_factors;
-
 };
 #endif
 //</aa>
@@ -36,7 +36,7 @@
 #include "content_distribution.h"
 #include "zipf.h"
 #include "zipf_sampled.h"
-#include <boost/dynamic_bitset.hpp>
+#include "onoff_schedule.h"
 #include <boost/tokenizer.hpp>
 
 
@@ -50,15 +50,9 @@ class ShotNoiseContentDistribution : public content_distribution{
 		// http://stackoverflow.com/a/7863971/2110769
 		#endif
 
-		// Functions related to the State Flags (ON/OFF) associated to contents.
-		void set_state_flag(int);
-		void unset_state_flag(int);
+		// State (ON/OFF) of a content at the current simulation time.
 		bool check_state_flag(int);
 
-		// Functions related to the Transition Times associated to each contents.
-		void set_state_time(int, simtime_t);
-		simtime_t get_state_time(int);
-
 		// Struct containing useful information associated to each popularity class.
 		struct classInfoEntry
 		{
@@ -104,8 +98,9 @@ class ShotNoiseContentDistribution : public content_distribution{
 
 
 	private:
-		boost::dynamic_bitset<>* state_flags;     	// Vector of State flags (i.e., 1=ON, 0=OFF) per each content.
-		vector<simtime_t>*	state_times;			// Vector of Transition Times per each content.
+		int find_class(int);
+
+		vector<onoff_schedule*> schedules;			// ON/OFF process of each class (NULL if the class is always ON).
 
 
 		#ifdef SEVERE_DEBUG
@@ -0,0 +1,57 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TRACECONTENT_DISTRIBUTION_H
+#define TRACECONTENT_DISTRIBUTION_H
+
+#include <omnetpp.h>
+#include "ccnsim.h"
+#include "content_distribution.h"
+#include "trace_file.h"
+
+
+using namespace std;
+
+/*
+ * 	Content distribution matching a request trace (replayed by client_Trace): the catalog
+ * 	is made of the contents of the trace, with their sizes. The trace is memory-mapped once,
+ * 	and shared by all the clients.
+ */
+class TraceContentDistribution : public content_distribution{
+	public:
+		trace_file trace;
+
+	protected:
+		void initialize();
+		void finish();
+
+		virtual filesize_t file_size(name_t);
+};
+#endif
@@ -0,0 +1,100 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ADAPTIVE_FORWARDING_H_
+#define ADAPTIVE_FORWARDING_H_
+
+#include "strategy_layer.h"
+#include "ccn_interest.h"
+#include "ccn_rng.h"
+
+class ccn_interest;
+using namespace std;
+
+
+/*
+ * 	Adaptive forwarding (NDN-style). Contents are hashed into buckets (the counterpart of name
+ * 	prefixes) and, for each bucket, every face keeps the smoothed Interest-Data RTT and the
+ * 	ratio of satisfied Interests, both measured when the PIT entry is satisfied (see
+ * 	interest_satisfied). Interests go through the face with the lowest RTT / satisfaction ratio
+ * 	among the next hops towards the repositories storing the content; faces not measured yet
+ * 	(or when nothing has been measured, the nearest repository) are discovered by probing: with
+ * 	probability probe_probability an Interest is sent through another candidate face instead.
+ *
+ * 	The first node choosing a face sets the target repository of the Interest, and the following
+ * 	nodes only adapt among the (equal-cost) next hops towards it, so that paths stay loop-free.
+ */
+class adaptive_forwarding : public strategy_layer{
+    public:
+	interface_t get_decision(cMessage *);
+	interface_t exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl; return 0;}
+	void interest_satisfied(chunk_t chunk, int face, double rtt);
+
+    protected:
+	void initialize();
+	void finish();
+	vector<int> choose_paths(int num_paths);
+	interface_t exploit(ccn_interest *);
+
+    private:
+	// Measurements of one face for one bucket (8 bytes).
+	struct face_record
+	{
+		float srtt;				// Smoothed RTT [s] (0 = not measured yet).
+		uint16_t forwarded;		// Interests forwarded (aged, see AGING_THRESHOLD).
+		uint16_t satisfied;		// Interests satisfied among them.
+	};
+
+	// Face through which a repository storing the content can be reached.
+	struct candidate
+	{
+		int face;
+		int len;
+		int repository;
+	};
+
+	static const uint16_t AGING_THRESHOLD = 1024;	// Counters are halved when 'forwarded' reaches it.
+
+	unsigned buckets;
+	unsigned faces;
+	double probe_probability;
+	ccn_rng rng;
+
+	vector<face_record> table;		// buckets x faces records.
+	vector<candidate> candidates;	// Scratch space of exploit (no allocation per Interest).
+
+	unsigned long probes;
+	unsigned long switches;			// Interests not sent through the nearest repository's face.
+
+	face_record &record(chunk_t chunk, int face){return table[(__id(chunk) % buckets) * faces + face];}
+	void add_candidates(int repository, int arrival_face);
+	double cost(const face_record &) const;
+};
+#endif
@@ -33,7 +33,9 @@
 
 
 #include "ccnsim.h"
+#include "tc_monitor.h"
 class DecisionPolicy;
+class request_log;
 
 
 
@@ -70,14 +72,19 @@ class base_cache : public abstract_node{
 		double tc_name_node; 		// (if 2-LRU) Used in reading Tc of name cache from file
 		void read_tc_value();
 		void read_tc_name_value();
+		int compact_name_cache_generations();
 		virtual void ttl_cache_check(){;}
 
 		int cache_size;
 
+		tc_monitor tc_meter;		// Sampled Tc measurement (fed by the replacement policies at eviction).
+
     public:
-		#ifdef SEVERE_DEBUG
-		base_cache():abstract_node(){initialized=false; };
-		#endif
+		base_cache():abstract_node(),req_log(NULL){
+			#ifdef SEVERE_DEBUG
+			initialized=false;
+			#endif
+		};
 
 		virtual void dump(){cout<<"Not implemented"<<endl;}
 
@@ -87,7 +94,11 @@ class base_cache : public abstract_node{
 		void set_size(uint32_t);
 
 		virtual bool fake_lookup(chunk_t);
+		virtual bool eviction_candidate(chunk_t &);	// Chunk that the next insertion would replace (false if unknown).
+		bool would_evict(chunk_t, chunk_t &);		// True if storing the chunk would replace the returned victim.
+		virtual double *cost_slot(chunk_t);			// Cost field of a cached chunk's descriptor (NULL if the engine has none).
 		bool lookup(chunk_t);
+		uint64_t lookup_train(chunk_t, int);	// Per-chunk lookup of a segment train; bit k is set iff the k-th chunk is a hit.
 
 		// Lookup without hit/miss statistics (used with the 2-LRU meta-caching strategy to lookup the name cache)
 		bool lookup_name(chunk_t);
@@ -123,6 +134,7 @@ class base_cache : public abstract_node{
 		int level;
 
 		DecisionPolicy *decisor;
+		request_log *req_log;		// Log of the looked up chunks (NULL if disabled).
 
 		// Average statistics
 		uint32_t miss;
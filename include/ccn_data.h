@@ -37,9 +37,12 @@
 #include <algorithm>
 
 class ccn_data: public ccn_data_Base{
+#ifdef CCN_PATH_TRACKING
 protected:
 
+	// Hop-by-hop path of the packet (debug only, compile with -DCCN_PATH_TRACKING).
 	std::deque<int> path;
+#endif
 
 public:
 	ccn_data(const char *name=NULL, int kind=0):ccn_data_Base(name,kind){;}
@@ -47,7 +50,9 @@ public:
 	ccn_data& operator=(const ccn_data& other){
 		if (&other==this) return *this;
 		ccn_data_Base::operator=(other);
+		#ifdef CCN_PATH_TRACKING
 		path = other.path;
+		#endif
 		return *this;
 	}
 	virtual ccn_data *dup() const {return new ccn_data(*this);}
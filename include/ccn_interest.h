@@ -40,70 +40,116 @@
 #include "error_handling.h"
 //</aa>
 
+/*
+ * 	Allocation-free iteration over the repositories storing a content, i.e., over the bits
+ * 	of its repo_t bitmask mapped onto content_distribution::repositories.
+ *
+ * 		for (repo_iterator it = interest->repos().begin(); it != interest->repos().end(); ++it)
+ * 			... *it ...
+ */
+class repo_iterator{
+public:
+	repo_iterator(repo_t _mask):mask(_mask),bit(0){skip();}
+	int operator*() const {return content_distribution::repositories[bit];}
+	repo_iterator& operator++(){mask >>= 1; bit++; skip(); return *this;}
+	bool operator!=(const repo_iterator& other) const {return mask != other.mask;}
+	bool operator==(const repo_iterator& other) const {return mask == other.mask;}
+
+private:
+	void skip(){while (mask && !(mask & 1)){mask >>= 1; bit++;}}
+	repo_t mask;	// Remaining repositories (the current one is the lowest bit).
+	int bit;		// Index of the current repository.
+};
+
+class repo_range{
+public:
+	repo_range(repo_t _mask):mask(_mask){;}
+	repo_iterator begin() const {return repo_iterator(mask);}
+	repo_iterator end() const {return repo_iterator(0);}
+	int size() const {return __builtin_popcount(mask);}
+	int operator[](int k) const {repo_iterator it(mask); while (k--) ++it; return *it;}	// k-th repository.
+
+private:
+	repo_t mask;
+};
+
 class ccn_interest: public ccn_interest_Base{
 protected:
 
+	// Repository bitmask of the requested content, cached at the first use (0 = not computed yet).
+	repo_t repo_mask;
+	name_t repo_mask_name;
+
+	#ifdef CCN_PATH_TRACKING
+	// Hop-by-hop path of the packet (debug only, compile with -DCCN_PATH_TRACKING).
 	std::deque<int> path;
+	#endif
 
 public:
-	ccn_interest(const char *name=NULL, int kind=0):ccn_interest_Base(name,kind){;}
-	ccn_interest(const ccn_interest_Base& other) : ccn_interest_Base(other.getName() ){ operator=(other); }
+	ccn_interest(const char *name=NULL, int kind=0):ccn_interest_Base(name,kind),repo_mask(0),repo_mask_name(0){;}
+	ccn_interest(const ccn_interest& other) : ccn_interest_Base(other.getName() ){ operator=(other); }
 	ccn_interest& operator=(const ccn_interest& other){
 		if (&other==this) return *this;
 		ccn_interest_Base::operator=(other);
+		repo_mask = other.repo_mask;
+		repo_mask_name = other.repo_mask_name;
+		#ifdef CCN_PATH_TRACKING
 		path = other.path;
+		#endif
 		return *this;
 	}
 	virtual ccn_interest *dup() const {return new ccn_interest(*this);}
-	virtual	void setPathArraySize(unsigned int size){;}
-	virtual unsigned int getPathArraySize() const{return path.size();}
-	virtual int getPath(unsigned int k) const{return path[k];}
-	virtual void setPath(unsigned int k, int path_var){path[k] = path_var;}
-	virtual void setPath(std::deque<int> new_path){path = new_path;}
-	virtual void pushPath (int path_var){path.push_back( path_var );}
-	virtual bool find(int index){return std::find(path.begin(),path.end(),index)!=path.end();}
-
-	virtual int popPath(){
+
+	#ifdef CCN_PATH_TRACKING
+	unsigned int getPathArraySize() const{return path.size();}
+	int getPath(unsigned int k) const{return path[k];}
+	void setPath(unsigned int k, int path_var){path[k] = path_var;}
+	void setPath(std::deque<int> new_path){path = new_path;}
+	void pushPath (int path_var){path.push_back( path_var );}
+	bool find(int index){return std::find(path.begin(),path.end(),index)!=path.end();}
+
+	int popPath(){
 	    int front=path.front();
 	    path.pop_front();
 	    return front;
 	}
+	#endif
 
 	virtual name_t get_name(){return __id(chunk_var);}
 	virtual name_t get_chunk_number(){return __chunk(chunk_var);}
 
-
-	virtual vector<int> get_repos()
+	repo_t get_repo_mask()
 	{
-	    repo_t repo;
-	    vector<int> repos;
-	    int i;
-
-	    repo = __repo(__id(chunk_var));
-	    i = 0;
-
-	    while (repo)
-	    {
-			if (repo & 1) 
-				repos.push_back(content_distribution::repositories[i]);
-			repo >>= 1;
-			i++;
-	    }
-
-		//<aa>
-		#ifdef SEVERE_DEBUG
-		if (repos.size() ==0){
-			std::stringstream ermsg; 
-			ermsg<<"There are 0 repositories for interest "<<__id(chunk_var);
-			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-		}
-		#endif
-		//</aa>
+		name_t name = __id(chunk_var);
+		if (repo_mask == 0 || repo_mask_name != name)
+		{
+			repo_mask = __repo(name);
+			repo_mask_name = name;
 
-	    return repos;
+			//<aa>
+			#ifdef SEVERE_DEBUG
+			if (repo_mask == 0){
+				std::stringstream ermsg; 
+				ermsg<<"There are 0 repositories for interest "<<name;
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			#endif
+			//</aa>
+		}
+		return repo_mask;
 	}
 
-	
+	// Repositories storing the requested content (no allocation).
+	repo_range repos(){return repo_range(get_repo_mask());}
+
+	// Same as repos(), copied into a vector (kept for the strategies that need one).
+	vector<int> get_repos()
+	{
+		vector<int> v;
+		for (repo_iterator it = repos().begin(); it != repos().end(); ++it)
+			v.push_back(*it);
+		return v;
+	}
 };
 Register_Class(ccn_interest);
 #endif 
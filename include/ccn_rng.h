@@ -0,0 +1,152 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef CCN_RNG_H_
+#define CCN_RNG_H_
+#include <omnetpp.h>
+#include <stdint.h>
+#include <cmath>
+#include <cstddef>
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
+
+/*
+ * 	Counter-based random number generator (Philox4x32-10, Salmon et al., SC'11).
+ *
+ * 	The k-th number of a stream is a pure function of (seed, module, stream, k): it does not
+ * 	depend on how many numbers other modules drew, nor on the order in which they were drawn.
+ * 	Hence, samples can be produced one by one, in batches (fill_*), or in disjoint counter ranges
+ * 	on different threads (seek, *_at) and results are bit-reproducible for a given seed.
+ *
+ * 	Every variate consumes exactly one counter, so that the position of a stream after n draws is
+ * 	always n, whatever the mix of distributions. Rejection samplers (e.g., zipf_sampled) take the
+ * 	counter of their variate (next_variate) and draw their retries from it (variate_uniform), so
+ * 	that the i-th variate can be computed without drawing the previous ones.
+ *
+ * 	The seed is the 'rng_seed' parameter of the network (0 if absent); modules are keyed by their ID.
+ */
+class ccn_rng
+{
+	public:
+		ccn_rng(uint64_t _seed = 0, uint32_t _module = 0, uint32_t _stream = 0):
+			seed(_seed),module(_module),stream(_stream),counter(0){;}
+
+		ccn_rng(cModule *m, uint32_t _stream):module(m->getId()),stream(_stream),counter(0)
+		{
+			cModule *net = cSimulation::getActiveSimulation()->getSystemModule();
+			seed = (net && net->hasPar("rng_seed")) ? (uint64_t)net->par("rng_seed").longValue() : 0;
+		}
+
+		// Philox4x32-10 block for the given key and counter.
+		static void block(uint64_t seed, uint32_t module, uint32_t stream, uint64_t ctr, uint32_t out[4])
+		{
+			uint32_t c0 = (uint32_t)ctr, c1 = (uint32_t)(ctr >> 32), c2 = module, c3 = stream;
+			uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+			for(int r=0; r < 10; r++)
+			{
+				uint64_t p0 = (uint64_t)0xD2511F53 * c0;
+				uint64_t p1 = (uint64_t)0xCD9E8D57 * c2;
+				uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+				uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+				c1 = (uint32_t)p1;
+				c3 = (uint32_t)p0;
+				c0 = n0;
+				c2 = n2;
+				k0 += 0x9E3779B9;
+				k1 += 0xBB67AE85;
+			}
+			out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+		}
+
+		// Uniform number in (0,1) at the given position of a stream.
+		static double uniform_at(uint64_t seed, uint32_t module, uint32_t stream, uint64_t ctr)
+		{
+			uint32_t w[4];
+			block(seed, module, stream, ctr, w);
+			return to_unit(w[0], w[1]);
+		}
+
+		/*
+		 * 	Uniform number of the attempt-th try of the variate at position ctr (rejection sampling).
+		 * 	Tries 0 and 1 use the two halves of the block of ctr (try 0 is uniform_at), the following
+		 * 	ones the blocks of ctr with attempt/2 folded into its 16 most significant bits, which the
+		 * 	sequential counters never reach.
+		 */
+		static double variate_uniform_at(uint64_t seed, uint32_t module, uint32_t stream, uint64_t ctr, uint32_t attempt)
+		{
+			uint32_t w[4];
+			block(seed, module, stream, ctr ^ ((uint64_t)(attempt >> 1) << 48), w);
+			return (attempt & 1) ? to_unit(w[2], w[3]) : to_unit(w[0], w[1]);
+		}
+
+		// Sequential draws.
+		double uniform(){return uniform_at(seed, module, stream, counter++);}
+		double uniform(double a, double b){return a + (b - a) * uniform();}
+		double exponential(double mean){return -mean * log(uniform());}
+		uint32_t intrand(uint32_t n){return (uint32_t)(uniform() * n);}
+
+		// Batched draws (identical to n sequential draws).
+		void fill_uniform(double *out, size_t n)
+		{
+			for(size_t i=0; i < n; i++)
+				out[i] = uniform_at(seed, module, stream, counter + i);
+			counter += n;
+		}
+		void fill_exponential(double *out, size_t n, double mean)
+		{
+			fill_uniform(out, n);
+			for(size_t i=0; i < n; i++)
+				out[i] = -mean * log(out[i]);
+		}
+
+		// Variates needing several uniforms (one counter each, see variate_uniform_at).
+		uint64_t next_variate(){return counter++;}
+		double variate_uniform(uint64_t ctr, uint32_t attempt) const {return variate_uniform_at(seed, module, stream, ctr, attempt);}
+
+		// Position of the stream.
+		void seek(uint64_t ctr){counter = ctr;}
+		uint64_t position() const {return counter;}
+
+	private:
+		static double to_unit(uint32_t hi, uint32_t lo)
+		{
+			uint64_t bits = (((uint64_t)hi << 32) | lo) >> 11;
+			return (bits + 0.5) * (1.0 / 9007199254740992.0);
+		}
+
+		uint64_t seed;
+		uint32_t module;
+		uint32_t stream;
+		uint64_t counter;
+};
+#endif
@@ -39,15 +39,16 @@
 
 //Core Layer Timer (Link Load Check)
 #define LOAD_CHECK 1010
+//Core Layer Timer (Delivery of packets through the fluid fast path)
+#define FLUID_DELIVERY 1011
+//Core Layer Timer (Expiration of PIT entries)
+#define PIT_CHECK 1012
 
 //Base Cache Timer (Expire Check)
 #define TTL_CHECK 1500
 #define TWO_TTL_CHECK 1501
 #define CONT_SHIFT 50
 
-//Client_Window (Window TO)
-#define WinTO 1020
-
 //Typedefs
 //Catalogs fields
 typedef unsigned int info_t; //representation for a catalog  entry [size|repos]
@@ -139,6 +140,10 @@ class abstract_node: public cSimpleModule{
 #define __schunk(h,c) h = ( (h & ~CHUNK_MSK) | ( (std::uint64_t ) c  << NUMBER_OFFSET)) //set chunk number
 #define __sid(h,id)   h = ( (h & ~ ID_MSK)   | ( (std::uint64_t ) id << ID_OFFSET)) //set chunk id
 
+//Maximum number of consecutive chunks carried by a single Interest/Data (segment train).
+//Hits within a train are tracked through a 64-bit mask.
+#define MAX_TRAIN 64
+
 inline chunk_t next_chunk (chunk_t c){
 
     cnumber_t n = __chunk(c);
@@ -147,6 +152,27 @@ inline chunk_t next_chunk (chunk_t c){
 
 }
 
+//Returns the k-th chunk following (k < 0: preceding) c within the same object (used to walk a segment train).
+inline chunk_t nth_chunk (chunk_t c, int k){
+
+    cnumber_t n = __chunk(c);
+    __schunk(c, (n+k) );
+    return c;
+
+}
+
+//Mask of the chunks [offset, offset+length) of a segment train (bit k: k-th chunk of the train).
+inline std::uint64_t train_mask (int offset, int length){
+
+    if (offset >= MAX_TRAIN || length <= 0)
+        return 0;
+    if (length > MAX_TRAIN - offset)
+        length = MAX_TRAIN - offset;
+    std::uint64_t bits = (length == MAX_TRAIN) ? ~(std::uint64_t) 0 : (((std::uint64_t) 1 << length) - 1);
+    return bits << offset;
+
+}
+
 
 
 
@@ -34,6 +34,7 @@
 #include <omnetpp.h>
 #include <random>
 #include "ccnsim.h"
+#include "ccn_rng.h"
 class statistics;
 class ccn_data;
 using namespace std;
@@ -109,7 +110,10 @@ class client : public cSimpleModule {
 		virtual void handle_timers(cMessage*);
 
 		void send_interest(name_t, cnumber_t, int);
-		void resend_interest(name_t,cnumber_t,int);
+		void resend_interest(name_t,cnumber_t,int,int range = 0);	// 'range': requested chunks (0: a whole train).
+		int train_length(name_t, cnumber_t);	// Length of the segment train starting from the given chunk.
+
+		static int last_nonce;		// Nonces are unique among all the Interests issued by the clients.
 
 		// List of current downloads for a given file.
 		multimap < name_t, download > current_downloads;
@@ -124,13 +128,13 @@ class client : public cSimpleModule {
 		//double lambda;
 		simtime_t check_time;
 
+		// Counter-based RNG for request generation (arrivals and content extraction).
+		ccn_rng rng;
+
 		// Vectors for Shot Noise statistics.
 		vector<double> scheduledReq;		// Number of scheduled requests for each popularity class.
 		vector<double> validatedReq;		// Number of validated requests for each popularity class.
 
-
-    private:
-
 		double tot_downloads; 		// Number of objects downloaded by the client.
 		unsigned int tot_chunks;
 
@@ -138,6 +142,8 @@ class client : public cSimpleModule {
 		simtime_t avg_time;
 		double avg_distance;
 
+    private:
 		double RTT;
+		int segment_train;		// Max number of consecutive chunks requested by a single Interest.
 };
 #endif
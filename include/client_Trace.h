@@ -0,0 +1,73 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef CLIENT_TRACE_H_
+#define CLIENT_TRACE_H_
+
+#include <omnetpp.h>
+#include "ccnsim.h"
+#include "client.h"
+#include "TraceContentDistribution.h"
+
+
+using namespace std;
+
+/*
+ * 	Client replaying the requests of a binary trace (see TraceContentDistribution). The
+ * 	i-th active client replays the requests of the i-th client of the trace.
+ */
+class client_Trace : public client {
+	protected:
+		virtual void initialize(int);				// Multi-stage initialization.
+		int numInitStages() const;
+		virtual void handleMessage(cMessage *);
+		virtual void finish();
+
+		virtual void request_file(name_t);
+
+		void slide_window();
+
+	private:
+		static TraceContentDistribution* trPointer;		// Pointer to the TraceContentDistribution class.
+
+		cMessage *arrival;
+		cMessage *timer;
+
+		const trace_record *cursor;			// Next request to be replayed.
+		const trace_record *end;			// End of the requests of this client.
+
+		// Sliding prefetch window.
+		long window;						// Size of the window [records].
+		const trace_record *window_begin;	// First record still mapped.
+		const trace_record *window_mark;	// Crossing this record, the window slides.
+
+		double time_scale;					// Multiplicative factor of the trace timestamps.
+};
+#endif
@@ -32,13 +32,24 @@
 #define CLIENT_WINDOW_H_
 
 #include <omnetpp.h>
-#include <random>
+#include <map>
 #include "ccnsim.h"
 #include "client.h"
 
 
 using namespace std;
 
+/*
+ * 	Receiver-driven congestion-controlled client. Objects are requested according to an IRM
+ * 	process (rate lambda), and each download pipelines its chunk Interests inside its own window:
+ * 		- "aimd": slow start up to ssthresh, then additive increase (one Interest per window of
+ * 		  Data), and multiplicative decrease (md_factor) at each timeout;
+ * 		- "delay": Vegas-like control on the RTT samples of the Data packets, i.e., the window
+ * 		  grows (shrinks) when less than delay_alpha (more than delay_beta) Interests are queued
+ * 		  inside the network, and it is decreased by md_factor at each timeout.
+ * 	The retransmission timeout of each download follows the smoothed RTT (Jacobson/Karn), and it
+ * 	is checked every check_time against the Interests in flight.
+ */
 class client_Window : public client {
 	public:
 
@@ -46,20 +57,56 @@ class client_Window : public client {
 		virtual void initialize();
 		virtual void handleMessage(cMessage *);
 		virtual void finish();
+		virtual void handle_incoming_chunk(ccn_data *);
+		virtual void handle_timers(cMessage *);
 
 		virtual void request_file(unsigned long);
 
-		void request_file_window(unsigned long);
-
     private:
+		// Interest in flight of a download.
+		struct pending_interest
+		{
+			simtime_t sent;		// Last (re)transmission.
+			int range;			// Requested chunks (segment train).
+			uint64_t missing;	// Chunks of the train not received yet (trains may come back split in runs).
+			bool retransmitted;	// No RTT sample is taken from retransmitted Interests (Karn).
+		};
+
+		// Congestion control state of a download.
+		struct window_flow
+		{
+			simtime_t start;
+			cnumber_t next_chunk;			// First chunk not requested yet.
+			filesize_t received;			// Chunks received so far.
+			double cwnd;					// Window [Interests].
+			double ssthresh;
+			double srtt, rttvar, rto;		// Smoothed RTT, its variation and retransmission timeout [s].
+			double min_rtt;					// Base RTT (delay-based control).
+			map<cnumber_t, pending_interest> in_flight;
+		};
+
+		enum {CC_AIMD, CC_DELAY};
+
 		cMessage *arrival;		// Message to trigger content requests.
 		cMessage *timer;		// Message to trigger timers.
 
-		cMessage *winTimeout;	// Message to trigger window reset.
-		int defWinSize;			// Initial and default window size.
+		int cc;					// Congestion control (CC_AIMD or CC_DELAY).
+		int defWinSize;			// Initial window size.
 		int maxWinSize;			// Maximum window size.
-		int currWinSize;		// Current window size.
-		int inFlightPkts; 		// Number of in flight packets.
-		double winTout;		// Time interval to reset the window size
+		double md_factor;		// Multiplicative decrease.
+		double delay_alpha, delay_beta;
+		double min_rto;
+		double init_rto;		// RTO of a new download (RTT parameter) [s].
+
+		multimap<name_t, window_flow> flows;
+
+		// Statistics.
+		unsigned long timeouts;
+		double rtt_sum;
+		unsigned long rtt_samples;
+
+		void fill_window(name_t, window_flow &);
+		void rtt_sample(window_flow &, double);
+		void open_window(window_flow &, double);
 };
 #endif
@@ -0,0 +1,104 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef CLOCK_CACHE_H_
+#define CLOCK_CACHE_H_
+
+#include "base_cache.h"
+#include "ccnsim.h"
+#include <vector>
+using namespace std;
+
+
+/*
+ * CLOCK (second chance) replacement cache. Cached chunks are kept inside a ring
+ * with a reference bit for each position, and indexed by a flat hash table (open
+ * addressing with linear probing). A hit only sets the reference bit of the chunk;
+ * when a new chunk must be inserted into a full cache, the clock hand sweeps the ring
+ * clearing the reference bits, and the first unreferenced chunk is replaced.
+ *
+ * The characteristic time Tc of the cache is estimated, as for lru_cache, once the
+ * stability is reached: it is the time an evicted chunk has spent inside the cache
+ * since its insertion or since its last second chance.
+ */
+class clock_cache: public base_cache
+{
+	friend class statistics;
+    public:
+		clock_cache():base_cache(),actual_size(0),hand(0),index_mask(0){;}
+
+		bool full();
+		void dump();
+		bool eviction_candidate(chunk_t &);
+		void flush();
+
+	//Polymorphic methods
+    protected:
+		void initialize();
+		void data_store (chunk_t);
+		bool data_lookup (chunk_t);
+		bool fake_lookup(chunk_t);
+
+		double get_tc_node();
+
+		void finish();
+
+    private:
+		// Position of the ring.
+		struct clock_slot
+		{
+			chunk_t k;			// Cached chunk.
+			double t;			// Insertion time or time of the last second chance (for the Tc estimate).
+		};
+
+		// Bucket of the hash index.
+		struct clock_bucket
+		{
+			chunk_t k;
+			uint32_t slot;		// Position of k inside the ring (EMPTY_BUCKET if the bucket is free).
+		};
+		static const uint32_t EMPTY_BUCKET = 0xFFFFFFFF;
+
+		uint32_t actual_size; 			//	Actual size of the cache (# objects).
+		uint32_t hand;					//	Position of the clock hand.
+		vector<clock_slot> ring;
+		vector<uint8_t> referenced;		//	Reference bit of each position of the ring.
+
+		vector<clock_bucket> index;		//	Hash index (load factor <= 0.5).
+		uint64_t index_mask;
+
+		void build();
+		void sweep();
+		uint64_t bucket_of(chunk_t) const;
+		uint32_t index_find(chunk_t) const;
+		void index_insert(chunk_t, uint32_t);
+		void index_erase(chunk_t);
+};
+#endif
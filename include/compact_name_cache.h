@@ -0,0 +1,244 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef COMPACT_NAME_CACHE_H_
+#define COMPACT_NAME_CACHE_H_
+
+#include "ccnsim.h"
+#include "error_handling.h"
+#include <vector>
+#include <cmath>
+#include <sstream>
+
+/*
+ * 	Compact Name Cache for the 2-LRU and 2-TTL meta-caching policies.
+ *
+ * 	The exact name caches (lru_cache, ttl_name_cache) keep a full list/map entry for each content ID,
+ * 	so that the Name Cache quickly dominates the memory footprint when it is much larger than the
+ * 	content store. This cache only stores a 16-bit fingerprint of each ID inside a cuckoo filter
+ * 	(buckets of 4 slots, partial-key cuckoo hashing), plus an 8-bit generation per slot that
+ * 	implements the aging:
+ *
+ * 		- the cache is aged (age()) by the policy, every NC/G insertions for 2-LRU and every Tc/G seconds
+ * 		  for 2-TTL, G being the number of generations;
+ * 		- an entry is valid as long as it has been inserted or refreshed in the last G generations;
+ * 		  older entries are cleared when their generation expires;
+ * 		- a hit refreshes the generation of the entry (i.e., it moves the entry to the head of the LRU,
+ * 		  or it renews its TTL).
+ *
+ * 	As a consequence, the 2-LRU flavor holds between NC*(G-1)/G and NC names, and the 2-TTL one keeps
+ * 	each name for a time between Tc*(G-1)/G and Tc. The price is a false positive probability (a never
+ * 	seen ID found in the cache), which is estimated by fp_rate(). The memory footprint is 3 bytes per slot.
+ */
+class compact_name_cache
+{
+    public:
+	compact_name_cache(uint64_t capacity, int num_generations):
+		generations(num_generations),current(0),live(0),overflows(0),load_sum(0),load_samples(0)
+	{
+		if (generations < 2 || generations > 128)
+		{
+			std::stringstream ermsg;
+			ermsg<<"The number of generations of the compact name cache must be in [2,128]. Please check.";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+
+		// Keep the load of the filter below 90%.
+		uint64_t needed = (uint64_t) ceil(capacity / (BUCKET * 0.9));
+		num_buckets = 1;
+		while (num_buckets < needed)
+			num_buckets <<= 1;
+		fingerprints.assign(num_buckets * BUCKET, 0);
+		gens.assign(num_buckets * BUCKET, 0);
+	}
+
+	/*
+	 * 	Looks up the given ID. In case of hit, the entry is refreshed.
+	 */
+	bool lookup(chunk_t chunk)
+	{
+		uint64_t h = mix(chunk);
+		uint16_t fp = fingerprint(h);
+		uint64_t b1 = h & (num_buckets - 1);
+		uint64_t b2 = alt_bucket(b1, fp);
+
+		load_sum += live * 1./fingerprints.size();
+		load_samples++;
+
+		int64_t s = find(b1, fp);
+		if (s < 0)
+			s = find(b2, fp);
+		if (s < 0)
+			return false;
+		gens[s] = current;
+		return true;
+	}
+
+	/*
+	 * 	Inserts the given ID (which is supposed to be absent, i.e., to have missed a lookup()).
+	 * 	When the filter is too crowded, the fingerprint kicked out by the last displacement
+	 * 	is dropped.
+	 */
+	void insert(chunk_t chunk)
+	{
+		uint64_t h = mix(chunk);
+		uint16_t fp = fingerprint(h);
+		uint8_t g = current;
+		uint64_t b = h & (num_buckets - 1);
+
+		if (place(b, fp, g) || place(alt_bucket(b, fp), fp, g))
+		{
+			live++;
+			return;
+		}
+
+		if (h & (1ULL << 63))
+			b = alt_bucket(b, fp);
+		for (int kick = 0; kick < MAX_KICKS; kick++)
+		{
+			// Swap the new entry with a victim of the bucket, and move the victim to its other bucket.
+			uint64_t s = b * BUCKET + ((h >> (kick % 32)) & (BUCKET - 1));
+			uint16_t vfp = fingerprints[s];
+			uint8_t vg = gens[s];
+			fingerprints[s] = fp;
+			gens[s] = g;
+			fp = vfp;
+			g = vg;
+			b = alt_bucket(b, fp);
+			if (place(b, fp, g))
+			{
+				live++;
+				return;
+			}
+		}
+		overflows++;	// The last victim is lost, the new entry is stored.
+	}
+
+	/*
+	 * 	Starts a new generation and clears the entries whose generation expires.
+	 */
+	void age()
+	{
+		current++;
+		uint8_t expired = current - generations;
+		for (uint64_t s = 0; s < fingerprints.size(); s++)
+			if (fingerprints[s] != 0 && gens[s] == expired)
+			{
+				fingerprints[s] = 0;
+				live--;
+			}
+	}
+
+	void flush()
+	{
+		fingerprints.assign(fingerprints.size(), 0);
+		live = 0;
+	}
+
+	// Number of valid entries.
+	uint64_t size() const {return live;}
+
+	// Memory occupied by the filter [bytes].
+	size_t bytes() const
+	{
+		return fingerprints.size() * (sizeof(uint16_t) + sizeof(uint8_t));
+	}
+
+	// Names dropped because the filter was too crowded.
+	uint64_t get_overflows() const {return overflows;}
+
+	/*
+	 * 	Estimated false positive probability of a lookup, given the average load seen by the lookups:
+	 * 	the 2*BUCKET slots of the two candidate buckets are compared with a fingerprint uniformly
+	 * 	distributed among 2^16-1 values.
+	 */
+	double fp_rate() const
+	{
+		double load = load_samples ? load_sum / load_samples : live * 1./fingerprints.size();
+		return 1 - pow(1 - 1./65535, 2 * BUCKET * load);
+	}
+
+    private:
+	static const int BUCKET = 4;
+	static const int MAX_KICKS = 500;
+
+	vector<uint16_t> fingerprints;	// 0 marks an empty slot.
+	vector<uint8_t> gens;			// Generation of the last insertion/refresh of each slot.
+	uint64_t num_buckets;			// Power of 2.
+	int generations;
+	uint8_t current;				// Current generation (wraps around).
+	uint64_t live;
+	uint64_t overflows;
+	double load_sum;
+	uint64_t load_samples;
+
+	static uint64_t mix(uint64_t k)
+	{
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	static uint16_t fingerprint(uint64_t h)
+	{
+		uint16_t fp = (h >> 32) & 0xFFFF;
+		return fp ? fp : 1;
+	}
+
+	// Partial-key cuckoo hashing: the other bucket only depends on the current one and on the fingerprint.
+	uint64_t alt_bucket(uint64_t b, uint16_t fp) const
+	{
+		return (b ^ mix(fp)) & (num_buckets - 1);
+	}
+
+	int64_t find(uint64_t b, uint16_t fp) const
+	{
+		for (uint64_t s = b * BUCKET; s < (b + 1) * BUCKET; s++)
+			if (fingerprints[s] == fp)
+				return (int64_t) s;
+		return -1;
+	}
+
+	bool place(uint64_t b, uint16_t fp, uint8_t g)
+	{
+		for (uint64_t s = b * BUCKET; s < (b + 1) * BUCKET; s++)
+			if (fingerprints[s] == 0)
+			{
+				fingerprints[s] = fp;
+				gens[s] = g;
+				return true;
+			}
+		return false;
+	}
+};
+#endif
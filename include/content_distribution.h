@@ -64,6 +64,8 @@ class content_distribution : public cSimpleModule{
 
 		virtual void finalize_total_replica();
 
+		virtual filesize_t file_size(name_t);	// Size [chunks] of a content of the catalog.
+
 		#ifdef SEVERE_DEBUG
 		virtual void verify_replica_number();
 		#endif
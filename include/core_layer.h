@@ -37,6 +37,10 @@
 
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
+#include <queue>
+#include <deque>
+#include <algorithm>
+#include "link_load_monitor.h"
 //#include "strategy_layer.h"
 
 using namespace std;
@@ -53,9 +57,85 @@ class base_cache;
 struct pit_entry
 {
     interface_t interfaces;			// Incoming interfaces.
-    unordered_set<int> nonces;		// Nonces of the Interest packets aggregated inside the same PIT entry.
+    int nonces[4];					// Nonces of the Interest packets aggregated inside the same PIT entry...
+    uint8_t n_nonces;				// ...(number of valid slots)...
+    vector<int> more_nonces;		// ...and the ones beyond the fourth (seldom used: no allocation otherwise).
     simtime_t time; 				// Last update time of the PIT entry.
     std::bitset<1> cacheable;		// Bit indicating if the retrieved Data packet should be cached or not.
+    int range;						// Length of the segment train requested through the entry (keyed by its first chunk).
+    uint64_t pending;				// Chunks of the train not received yet (bit k: k-th chunk of the train).
+
+    // Records the nonce of an Interest aggregated to the entry. Returns false if it was already there.
+    bool add_nonce(int nonce)
+    {
+    	for (int i = 0; i < n_nonces; i++)
+    		if (nonces[i] == nonce)
+    			return false;
+    	if (std::find(more_nonces.begin(), more_nonces.end(), nonce) != more_nonces.end())
+    		return false;
+    	if (n_nonces < 4)
+    		nonces[n_nonces++] = nonce;
+    	else
+    		more_nonces.push_back(nonce);
+    	return true;
+    }
+};
+
+//	Creation record of a PIT entry, kept in the PIT timing wheel. The record is stale (and it is
+//	skipped) if the entry has been satisfied or re-created in the meantime.
+struct pit_timer
+{
+	chunk_t chunk;
+	simtime_t time;			// Creation time of the PIT entry.
+};
+
+//	PIT counters of a face.
+struct pit_face_stats
+{
+	unsigned long aggregated;	// Interests arrived through the face and aggregated to a pending PIT entry.
+	unsigned long duplicates;	// Interests arrived through the face with a nonce already in the PIT entry.
+	unsigned long satisfied;	// Data sent through the face to satisfy PIT entries.
+};
+
+class core_layer;
+
+//	Face that can be crossed through the fluid fast path (i.e., a link without datarate
+//	towards another core_layer).
+struct fluid_link
+{
+	core_layer *peer;		// core_layer of the neighbor (NULL if the packet must cross the channel).
+	int peer_gate;			// Id of the arrival gate at the neighbor.
+	cChannel *channel;		// Channel of the link (checked for link failures).
+	simtime_t delay;		// Propagation delay of the link.
+};
+
+//	Packet travelling through the fluid fast path, waiting to be delivered.
+struct fluid_arrival
+{
+	simtime_t time;			// Arrival time.
+	unsigned long seq;		// Packets arriving at the same time are delivered in FIFO order.
+	cMessage *msg;
+	int gate;				// Id of the arrival gate.
+
+	bool operator>(const fluid_arrival &other) const
+	{
+		return time > other.time || (time == other.time && seq > other.seq);
+	}
+};
+
+//	Transmission queue of a face (shaping): FIFO queue with serialization delay. The queue is
+//	represented only by the time at which the face becomes idle again, so that shaping needs
+//	neither extra modules nor extra events.
+struct face_queue
+{
+	static const int INTEREST_BITS = 64*8;	// Size of an Interest packet.
+
+	double rate;			// Datarate of the face [bps] (0 = not shaped, e.g., towards clients).
+	simtime_t busy_until;	// End of the transmission of the last queued packet.
+	double limit;			// Backlog [bits] beyond which packets are dropped (0 = never).
+	unsigned long sent;
+	unsigned long dropped;
+	double wait;			// Total queueing delay of the sent packets [s].
 };
 
 
@@ -75,10 +155,13 @@ class core_layer : public abstract_node{
 		double get_repo_price();
 		int getOutInt(int dest);
 
+		// Fluid fast path: hands a packet sent by a neighbor to this node (it will arrive on 'gate' at 'time').
+		void fluid_deliver(cMessage *msg, int gate, simtime_t time);
+		virtual ~core_layer();
+
 		// *** Added for model execution with NRR
 		virtual strategy_layer* get_strategy() const;
 
-		bool stable;   // Used for collecting load samples only after the stabilization;
 		double datarate;
 		// *** Link Load Evaluation ***
 		bool llEval;
@@ -94,9 +177,10 @@ class core_layer : public abstract_node{
 		void add_to_pit(chunk_t chunk, int gate);
 
 		void handle_interest(ccn_interest *);
+		void serve_interest(ccn_interest *, bool, bool);	// Serves an Interest (or a run of a segment train) already looked up in the cache.
 		void handle_ghost(ccn_interest *);
 		void handle_data(ccn_data *);
-		void handle_decision(bool *, ccn_interest *);
+		void handle_decision(interface_t, ccn_interest *);
 
 
 		bool check_ownership(vector<int>);
@@ -113,25 +197,7 @@ class core_layer : public abstract_node{
 
 		double simDuration;
 
-		// global statistics
-		// With percentiles
-		//double** numPackets;
-		double** numBits; // double to avoid overflow
-		// Wothout percentiles
-		//double* numPackets;
-		//double* numBits; // double to avoid overflow
-
-		// current measurement interval
-		// With percentiles
-		//unsigned long** intvlNumPackets;
-		//unsigned long** intvlNumBits;
-		// Without percentiles
-		//unsigned long* intvlNumPackets;
-		//unsigned long* intvlNumBits;
-
-		double percentiles [11] = {0.5, 0.55, 0.6, 0.65, 0.7, 0.75, 0.8, 0.85, 0.9, 0.95, 1};
-		unsigned int* percID;
-		int numPercentiles = 11;
+		link_load_monitor link_loads;		// Bits sent through each face.
 
     private:
 		unsigned long max_pit;
@@ -151,14 +217,68 @@ class core_layer : public abstract_node{
 		base_cache *ContentStore;
 		strategy_layer *strategy;
 
+		// *** PIT aggregation statistics ***
+		vector<pit_face_stats> pit_faces;	// One entry per face.
+		unsigned long pit_forwarded;		// Interests forwarded upstream after a PIT lookup.
+		unsigned long pit_saved_chunks;		// Chunks not requested upstream thanks to aggregation.
+		unsigned long pit_satisfied;		// Data packets satisfying PIT entries.
+		int pit_max_range;					// Longest train requested through the PIT (bounds the lookups of handle_data).
+
 		// Statistics
 		int interests;
 		int data;
 
 		int	send_data (ccn_data* msg, const char *gatename, int gateindex, int line_of_the_call);
 
+		// *** Fluid fast path ***
+		// Packets sent through links without datarate skip the gate/channel machinery and are
+		// handed directly to the neighbor's core_layer, which delivers them in arrival-time order.
+		bool fluid;
+		vector<fluid_link> fluid_links;		// One entry per face.
+		std::priority_queue<fluid_arrival, vector<fluid_arrival>, std::greater<fluid_arrival> > fluid_queue;
+		unsigned long fluid_seq;
+		cMessage *fluid_timer = NULL;		// Scheduled at the arrival time of the head of fluid_queue.
+
+		void setup_fluid_links();
+		bool fluid_reachable(int face);
+		void fluid_send(cMessage *msg, int face, simtime_t delay);
+
+		// *** Face shaping ***
+		bool shaping;
+		vector<face_queue> face_queues;		// One entry per face.
+
+		void setup_face_queues();
+		bool face_enqueue(int face, double bits, simtime_t &delay);
+
+		// *** PIT lifetime and capacity ***
+		// PIT entries are expired through a timing wheel: the records of the entries created during a
+		// tick go in the same slot, and the whole slot is expired PIT_WHEEL_SLOTS-1 ticks later. Since
+		// slots are filled in creation order, the wheel also gives the oldest entry (evict_oldest).
+		static const unsigned PIT_WHEEL_SLOTS = 64;
+
+		double pit_lifetime;				// Entries expire within one tick after pit_lifetime seconds (0 = never).
+		simtime_t pit_tick;
+		bool pit_evict_oldest;				// Full PIT: evict the oldest entry (otherwise drop the Interest).
+		bool pit_managed;					// Records are kept only with a lifetime or a capacity.
+		vector< std::deque<pit_timer> > pit_wheel;
+		unsigned pit_cursor;				// Slot expired by the last tick.
+		unsigned long pit_records;			// Records inside the wheel (valid or stale).
+		cMessage *pit_check = NULL;
+
+		unsigned long pit_expired;			// Entries expired without being satisfied.
+		unsigned long pit_evicted;			// Entries evicted to make room.
+		unsigned long pit_drops;			// Interests dropped because the PIT was full.
+		unsigned long pit_peak;				// Maximum number of entries.
+
+		void pit_track(chunk_t chunk);
+		bool pit_admit();
+		bool pit_valid(const pit_timer &record);
+		void pit_expire();
+
 		//*** Link Load Evaluation ***
-		cMessage *load_check;
+		cMessage *load_check = NULL;		// End of the current measurement interval (every maxInterval).
+		vector<string> ll_names;			// "<node>-><next node>" of each measured face.
+		vector<cOutVector*> ll_vectors;		// Time series of each face (if the results sink is disabled).
 		void evaluateLinkLoad();
 
 
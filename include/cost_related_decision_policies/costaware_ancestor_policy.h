@@ -35,6 +35,7 @@
 #include "decision_policy.h"
 #include "error_handling.h"
 #include "WeightedContentDistribution.h"
+#include "results_sink.h"
 
 #define UNSET_COST -1
 
@@ -110,12 +111,8 @@ class Costaware_ancestor: public DecisionPolicy{
 		virtual bool data_to_cache(ccn_data * data_msg) = 0;
 
 		virtual void finish (int nodeIndex, base_cache* cache_p){			
-		    char name [30];
-			sprintf ( name, "correction_factor[%d]", nodeIndex);
-			cache_p->recordScalar (name, correction_factor);
-
-			sprintf ( name, "kappa[%d]", nodeIndex);
-			cache_p->recordScalar (name, kappa);
+			record_result(cache_p, "node", nodeIndex, "correction_factor", correction_factor);
+			record_result(cache_p, "node", nodeIndex, "kappa", kappa);
 		};
 
 		virtual double get_last_accepted_content_price(){
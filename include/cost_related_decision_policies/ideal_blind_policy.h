@@ -34,26 +34,19 @@
 //<aa>
 #include "decision_policy.h"
 #include "error_handling.h"
-#include "lru_cache.h"
+#include "base_cache.h"
 
+// Works with any replacement engine exposing its eviction candidate (see
+// base_cache::eviction_candidate).
 class Ideal_blind: public DecisionPolicy{
 	protected:
-		lru_cache* mycache; // cache I'm attached to
+		base_cache* mycache; // cache I'm attached to
 
     public:
 		Ideal_blind(base_cache* mycache_par):
 			DecisionPolicy()
 		{
-			mycache = dynamic_cast<lru_cache*>(mycache_par);
-
-			// CHECK{
-				if( mycache == NULL ){
-					std::stringstream ermsg; 
-					ermsg<<"this policy works only with lru";
-					severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-				}
-			// }CHECK
-
+			mycache = mycache_par;
 		};
 
 		virtual bool data_to_cache(ccn_data * data_msg)
@@ -68,15 +61,23 @@ class Ideal_blind: public DecisionPolicy{
 			}
 			#endif
 
+			chunk_t new_content_index = data_msg->getChunk();
+			chunk_t victim_index;
 			if (! mycache->full() )
 				decision = true;
+			else if (! mycache->would_evict(new_content_index, victim_index) ){
+				// CHECK{
+				if ( !mycache->fake_lookup(new_content_index) ){
+					std::stringstream ermsg; 
+					ermsg<<"this policy needs a cache that exposes its eviction candidate";
+					severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+				}
+				// }CHECK
+				decision = true;	// Already cached: nothing is replaced
+			}
 			else{
 
-				chunk_t new_content_index = data_msg->getChunk();
-				lru_pos* lru_element_descriptor = mycache->get_lru();
-				chunk_t lru_index = lru_element_descriptor->k;
-
-				if (new_content_index <= lru_index)
+				if (new_content_index <= victim_index)
 					// Inserting this content in the cache would make it better
 					decision = true;
 				else 
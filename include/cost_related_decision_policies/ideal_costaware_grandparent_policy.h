@@ -35,7 +35,8 @@
 #include "decision_policy.h"
 #include "error_handling.h"
 #include "costaware_ancestor_policy.h"
-#include "lru_cache.h"
+#include "base_cache.h"
+#include <boost/unordered_map.hpp>
 #include "WeightedContentDistribution.h"
 
 // This is an abstract class
@@ -44,10 +45,28 @@
 // object has a weight greater than the eviction candidate. Doing this way, the insertion
 // of the new object makes the cache content "more valuable".
 // See data_to_cache(..) to understand better.
+// The eviction candidate is asked to the cache (see base_cache::eviction_candidate),
+// so that any replacement engine exposing it can be used. The costs of the cached
+// objects are annotated inside the descriptors of the cache when it has room for them
+// (see base_cache::cost_slot, e.g., lru_cache), otherwise they are kept by the policy.
 class Ideal_costaware_grandparent: public Costaware_ancestor{
 	protected:
 		double alpha;
-		lru_cache* mycache; // cache I'm attached to
+		base_cache* mycache; // cache I'm attached to
+
+		boost::unordered_map<chunk_t,double> cached_cost;	// Cost of each cached object (engines without cost_slot)
+		chunk_t last_accepted_chunk;
+		chunk_t pending_victim;		// Eviction candidate when the last object was accepted
+		bool victim_pending;
+
+		double get_cached_cost(chunk_t id)
+		{
+			double *slot = mycache->cost_slot(id);
+			if (slot)
+				return *slot;
+			boost::unordered_map<chunk_t,double>::iterator it = cached_cost.find(id);
+			return it == cached_cost.end() ? 0 : it->second;
+		}
 
     public:
 		Ideal_costaware_grandparent(double average_decision_ratio_, base_cache* mycache_par):
@@ -60,15 +79,8 @@ class Ideal_costaware_grandparent: public Costaware_ancestor{
 				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 			}
 			alpha = content_distribution_module->get_alpha();
-			mycache = dynamic_cast<lru_cache*>(mycache_par);
-
-			// CHECK{
-				if( mycache == NULL ){
-					std::stringstream ermsg; 
-					ermsg<<"This policy works only with lru";
-					severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-				}
-			// }CHECK
+			mycache = mycache_par;
+			victim_pending = false;
 
 		};
 
@@ -87,19 +99,27 @@ class Ideal_costaware_grandparent: public Costaware_ancestor{
 			chunk_t content_index = data_msg->getChunk();
 			double cost = data_msg->getPrice();
 			double x;
+			chunk_t victim_index;
+			bool has_victim = false;
 			if (! mycache->full() )
 				decision = decide_with_cache_not_full(content_index, cost);
+			else if (! (has_victim = mycache->would_evict(content_index, victim_index)) ){
+				// CHECK{
+				if ( !mycache->fake_lookup(content_index) ){
+					std::stringstream ermsg; 
+					ermsg<<"This policy needs a cache that exposes its eviction candidate";
+					severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+				}
+				// }CHECK
+				decision = true;	// Already cached: only its cost is refreshed
+			}
 			else{
 
 				double new_content_weight = compute_content_weight(content_index,cost);
+				double victim_weight = compute_content_weight(victim_index,
+						get_cached_cost(victim_index) );
 
-
-				lru_pos* lru_element_descriptor = mycache->get_lru();
-				content_index = lru_element_descriptor->k;
-				cost = lru_element_descriptor->cost;
-				double lru_weight = compute_content_weight(content_index,cost);
-
-				if (new_content_weight > lru_weight)
+				if (new_content_weight > victim_weight)
 				{	// Inserting this content in the cache would make it better
 					decision = true;
 
@@ -114,11 +134,22 @@ class Ideal_costaware_grandparent: public Costaware_ancestor{
 			}
 
 			if (decision == true)
+			{
 				set_last_accepted_content_price(data_msg );
+				last_accepted_chunk = data_msg->getChunk();
+				victim_pending = has_victim;
+				pending_victim = victim_index;
+			}
 
 			return decision;
 		};
 
+		virtual void after_flush()
+		{
+			cached_cost.clear();
+			victim_pending = false;
+		}
+
 		virtual double compute_correction_factor(){
 			return 0;
 		};
@@ -137,8 +168,18 @@ class Ideal_costaware_grandparent: public Costaware_ancestor{
 			}
 			#endif
 
-			// Annotate the cost of the last inserted element
-			mycache->get_mru()->cost = get_last_accepted_content_price();
+			// Annotate the cost of the last inserted element and forget the one of
+			// the evicted element (unless other replicas keep it cached, as in FIFO)
+			double *slot = mycache->cost_slot(last_accepted_chunk);
+			if (slot)
+				*slot = get_last_accepted_content_price();
+			else
+			{
+				cached_cost[last_accepted_chunk] = get_last_accepted_content_price();
+				if (victim_pending && !mycache->fake_lookup(pending_victim) )
+					cached_cost.erase(pending_victim);
+			}
+			victim_pending = false;
 
 			#ifdef SEVERE_DEBUG
 			// Unset this field to check if it is set again at the appropriate time
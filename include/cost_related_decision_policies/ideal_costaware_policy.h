@@ -34,7 +34,6 @@
 //<aa>
 #include "decision_policy.h"
 #include "error_handling.h"
-#include "lru_cache.h"
 #include "WeightedContentDistribution.h"
 #include "ideal_costaware_parent_policy.h"
 
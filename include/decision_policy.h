@@ -51,6 +51,16 @@ class DecisionPolicy : public cSimpleModule {
 			// Do nothing
 		};
 		//</aa>
+
+		// Called by base_cache.cc for every lookup, i.e., for every request seen by the cache.
+		virtual void after_lookup_action(chunk_t){
+			// Do nothing
+		};
+
+		// Called by the caches when they are flushed: state kept about the cached objects must be dropped.
+		virtual void after_flush(){
+			// Do nothing
+		};
 };
 #endif
 
@@ -49,14 +49,12 @@ class fifo_cache: public base_cache
     public:
 		fifo_cache():base_cache(),actual_size(0){;}
 
-		double nodeTc = 0;
-		double tcSamples = 0;
-
 		bool full();
 		void dump();
 		void flush();
 
 		chunk_t get_toErase();   		  // Get the chunk to be erased if the cache is full.
+		bool eviction_candidate(chunk_t &);
 
 		bool check_if_eraseElement(chunk_t);    // Check if the number of replicas inside the deque is zero
 
@@ -73,12 +71,10 @@ class fifo_cache: public base_cache
 
     private:
 		uint32_t actual_size; 				//	Actual size of the cache (# objects).
-		deque<chunk_t> deq;					//	Deque for the order
-		unordered_map<chunk_t,int> cache;	//	Map for a look up
-
-		// Collect info about the Tc
-		map < chunk_t, double> monitored_contents;
+		typedef pair<chunk_t, double> fifo_entry;	// Cached chunk and its insertion time.
 
+		deque<fifo_entry> deq;				//	Deque for the order
+		unordered_map<chunk_t,int> cache;	//	Map for a look up
 
 };
 #endif
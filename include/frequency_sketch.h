@@ -0,0 +1,179 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef FREQUENCY_SKETCH_H_
+#define FREQUENCY_SKETCH_H_
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Approximate frequency counter used by the TinyLFU admission policy: a count-min sketch
+ * with 4 rows of 4-bit counters (16 counters packed in each 64-bit word). Counters are
+ * increased with the conservative update rule, and they are all halved after 'sample_size'
+ * increments (aging), so that the sketch follows the recent popularity of contents.
+ *
+ * An optional doorkeeper (Bloom filter) absorbs the first occurrence of each content since
+ * the last aging: one-hit wonders never reach the counters.
+ *
+ * The class does not depend on OMNeT++, so that it can be linked by the off-line tools
+ * (see scripts/admission_bench.cc).
+ */
+class frequency_sketch
+{
+    public:
+	frequency_sketch(uint64_t counters, uint64_t sample, bool use_doorkeeper):
+		sample_size(sample),additions(0),doorkeeper_on(use_doorkeeper)
+	{
+		width = 16;
+		while (width < counters)
+			width <<= 1;
+		table.assign(DEPTH * (width / 16), 0);
+		if (doorkeeper_on)
+			doorkeeper.assign(width / 64 > 0 ? width / 64 : 1, 0);	// One bit per counter of a row.
+	}
+
+	// Records a request for the given chunk.
+	void increment(uint64_t chunk)
+	{
+		uint64_t h = mix(chunk);
+
+		if (doorkeeper_on && !doorkeeper_test_and_set(h))
+			;	// First occurrence since the last aging: only the doorkeeper remembers it.
+		else
+		{
+			unsigned min = estimate_counters(h);
+			if (min < 15)
+				for (int i = 0; i < DEPTH; i++)
+					if (counter(i, h) == min)
+						set_counter(i, h, min + 1);
+		}
+
+		if (++additions >= sample_size)
+			age();
+	}
+
+	// Estimated number of requests for the given chunk since the last aging.
+	unsigned estimate(uint64_t chunk) const
+	{
+		uint64_t h = mix(chunk);
+		unsigned f = estimate_counters(h);
+		if (doorkeeper_on && doorkeeper_test(h))
+			f++;
+		return f;
+	}
+
+	// Memory used by the sketch and by the doorkeeper [bytes].
+	size_t bytes() const
+	{
+		return (table.size() + doorkeeper.size()) * sizeof(uint64_t);
+	}
+
+    private:
+	static const int DEPTH = 4;
+
+	std::vector<uint64_t> table;			// DEPTH rows of 'width' 4-bit counters.
+	std::vector<uint64_t> doorkeeper;	// Bits of the doorkeeper.
+	uint64_t width;					// Counters per row (power of 2).
+	uint64_t sample_size;			// Increments between two agings.
+	uint64_t additions;
+	bool doorkeeper_on;
+
+	static uint64_t mix(uint64_t k)
+	{
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	// Position of the counter of row i (double hashing on the two halves of h).
+	uint64_t position(int i, uint64_t h) const
+	{
+		uint64_t step = (h >> 32) | 1;
+		return i * width + (((h & 0xFFFFFFFF) + i * step) & (width - 1));
+	}
+
+	unsigned counter(int i, uint64_t h) const
+	{
+		uint64_t p = position(i, h);
+		return (table[p >> 4] >> ((p & 15) << 2)) & 0xF;
+	}
+
+	void set_counter(int i, uint64_t h, unsigned v)
+	{
+		uint64_t p = position(i, h);
+		int shift = (p & 15) << 2;
+		table[p >> 4] = (table[p >> 4] & ~((uint64_t)0xF << shift)) | ((uint64_t)v << shift);
+	}
+
+	unsigned estimate_counters(uint64_t h) const
+	{
+		unsigned min = 15;
+		for (int i = 0; i < DEPTH; i++)
+		{
+			unsigned c = counter(i, h);
+			if (c < min)
+				min = c;
+		}
+		return min;
+	}
+
+	// The doorkeeper uses two bits, taken from the bits of h not used by the first row.
+	bool doorkeeper_test(uint64_t h) const
+	{
+		uint64_t bits = doorkeeper.size() * 64;
+		uint64_t a = (h >> 17) & (bits - 1), b = (h >> 41) & (bits - 1);
+		return ((doorkeeper[a >> 6] >> (a & 63)) & 1) && ((doorkeeper[b >> 6] >> (b & 63)) & 1);
+	}
+
+	bool doorkeeper_test_and_set(uint64_t h)
+	{
+		bool present = doorkeeper_test(h);
+		uint64_t bits = doorkeeper.size() * 64;
+		uint64_t a = (h >> 17) & (bits - 1), b = (h >> 41) & (bits - 1);
+		doorkeeper[a >> 6] |= (uint64_t)1 << (a & 63);
+		doorkeeper[b >> 6] |= (uint64_t)1 << (b & 63);
+		return present;
+	}
+
+	// Halves all the counters and resets the doorkeeper.
+	void age()
+	{
+		for (size_t w = 0; w < table.size(); w++)
+			table[w] = (table[w] >> 1) & 0x7777777777777777ULL;
+		std::fill(doorkeeper.begin(), doorkeeper.end(), 0);
+		additions /= 2;
+	}
+};
+#endif
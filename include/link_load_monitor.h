@@ -0,0 +1,144 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef LINK_LOAD_MONITOR_H_
+#define LINK_LOAD_MONITOR_H_
+
+#include <vector>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <stdint.h>
+#include "results_sink.h"
+
+/*
+ * 	Link load measurement of the output faces of a node (llEval).
+ *
+ * 	Each face keeps the bits sent since the last reset of the statistics and since the
+ * 	beginning of the current measurement interval (maxInterval). Optionally, the bits
+ * 	since the reset are also broken down by content rank, inside 'buckets' bins
+ * 	logarithmically spaced over [1, catalog]: memory is O(faces * buckets) instead of
+ * 	O(faces * catalog), and the cost per sent Data is a binary search over the bin edges.
+ * 	Faces are numbered as the face[] gates of the core layer; face 0 (towards the client)
+ * 	is not measured.
+ */
+class link_load_monitor
+{
+    public:
+		static const int DATA_BITS = 1536*8;	// Size of a Data packet.
+
+		link_load_monitor():faces(0),start(0){;}
+
+		void init(int num_faces, uint64_t catalog, int buckets)
+		{
+			faces = num_faces;
+			edges.clear();
+			if (buckets > 0)
+			{
+				// Lower rank of each bin: 1, catalog^(1/B), catalog^(2/B), ... (duplicates merged).
+				for (int b = 0; b < buckets; b++)
+				{
+					uint64_t e = (uint64_t) ceil(pow((double) catalog, (double) b / buckets));
+					if (edges.empty() || e > edges.back())
+						edges.push_back(e);
+				}
+			}
+			total.assign(faces, 0);
+			interval.assign(faces, 0);
+			per_rank.assign(faces * edges.size(), 0);
+		}
+
+		bool enabled() const {return faces > 0;}
+		int bins() const {return edges.size();}
+
+		// 'chunks' Data packets of content 'id' sent through 'face'.
+		void account(int face, uint64_t id, int chunks)
+		{
+			double bits = (double) DATA_BITS * chunks;
+			total[face] += bits;
+			interval[face] += bits;
+			if (!edges.empty())
+			{
+				size_t b = std::upper_bound(edges.begin(), edges.end(), id) - edges.begin();
+				per_rank[face * edges.size() + (b > 0 ? b - 1 : 0)] += bits;
+			}
+		}
+
+		// Bits sent through 'face' during the current interval (the interval counter is reset).
+		double end_interval(int face)
+		{
+			double bits = interval[face];
+			interval[face] = 0;
+			return bits;
+		}
+
+		// Reset of the statistics at time 'now' (e.g., at the end of the transient).
+		void clear(double now)
+		{
+			start = now;
+			total.assign(total.size(), 0);
+			per_rank.assign(per_rank.size(), 0);
+		}
+
+		/*
+		 * 	Records the average load (bits per second over datarate) of each face since the
+		 * 	last reset, and its breakdown by rank bin ("ll_face<f>_rank<lowest rank of the bin>").
+		 */
+		template <class M>
+		void record(M *module, int index, double now, double datarate) const
+		{
+			double elapsed = now - start;
+			if (elapsed <= 0)
+				return;
+			for (int f = 0; f < faces; f++)
+			{
+				std::stringstream name;
+				name << "ll_face" << f + 1;
+				record_result(module, "node", index, name.str().c_str(), total[f] / elapsed / datarate);
+				for (size_t b = 0; b < edges.size(); b++)
+				{
+					std::stringstream bin_name;
+					bin_name << name.str() << "_rank" << edges[b];
+					record_result(module, "node", index, bin_name.str().c_str(),
+							per_rank[f * edges.size() + b] / elapsed / datarate);
+				}
+			}
+		}
+
+    private:
+		int faces;
+		double start;				// Time of the last reset [s].
+		std::vector<uint64_t> edges;	// Lowest rank of each bin.
+		std::vector<double> total;		// Bits sent since the last reset (double to avoid overflow).
+		std::vector<double> interval;	// Bits sent during the current interval.
+		std::vector<double> per_rank;	// per_rank[face * bins + bin]
+};
+#endif
@@ -47,7 +47,7 @@ struct lru_pos
     lru_pos* older;			// Immediately least recently used element with respect to the current one.
     lru_pos* newer;			// Immediately most recently used element with respect to the current one.
     chunk_t k;				// Content name of the current element.
-    simtime_t hit_time;		// Time of the hit event.
+    simtime_t hit_time;		// Time of the insertion or of the last hit (used for the Tc measurement).
 	double cost; 			// Used only with cost aware caching.
 };
 
@@ -60,16 +60,14 @@ class lru_cache:public base_cache
 
 		lru_pos* get_mru();
 		lru_pos* get_lru();
-		const lru_pos* get_eviction_candidate();
+		bool eviction_candidate(chunk_t &);
+		double *cost_slot(chunk_t);
 	
 		bool full();
 		void dump();
 
 		void flush();
 
-		double nodeTc = 0;
-		double tcSamples = 0;
-
 
     protected:
 		void data_store(chunk_t);
@@ -86,10 +84,5 @@ class lru_cache:public base_cache
 		lru_pos* mru; 			//	Actual Most Recently Used object.
 
 		unordered_map<chunk_t, lru_pos*> cache; 	// Implemented LRU cache.
-
-		// Collect info about the Tc
-		map < chunk_t, double> monitored_contents;
-		//double nodeTc = 0;
-		//double tcSamples = 0;
 };
 #endif
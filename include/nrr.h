@@ -51,11 +51,11 @@ bool operator<(const Centry &a, const Centry &b){
 class nrr: public MonopathStrategyLayer{
     public:
 	void initialize();
-	bool *get_decision(cMessage *in);
-	bool *exploit(ccn_interest *interest);
+	interface_t get_decision(cMessage *in);
+	interface_t exploit(ccn_interest *interest);
 	// *** Only for model execution
-	bool *exploit_model(long m);
-	int nearest(vector<int>&);
+	interface_t exploit_model(long m);
+	int nearest(repo_range);
 	void finish();
     private:
 	unordered_map<name_t,int_f> dynFIB;
@@ -32,21 +32,22 @@
 #define DLEARNING_H_
 
 #include "MonopathStrategyLayer.h"
+#include "ccn_interest.h"
 class ccn_interest;
 
 using namespace std;
 
 class nrr1 : public MonopathStrategyLayer{
     public:
-	bool* get_decision(cMessage *);
+	interface_t get_decision(cMessage *);
     protected:
 	//Exploration and exploitation functions
-	bool *exploit(ccn_interest *);
-	bool *explore(ccn_interest *);
-	int  nearest(vector<int>& );
-	bool *exploit_nearest(ccn_interest *);
+	interface_t exploit(ccn_interest *);
+	interface_t explore(ccn_interest *);
+	int  nearest(repo_range);
+	interface_t exploit_nearest(ccn_interest *);
 
-	bool *exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl;}
+	interface_t exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl; return 0;}
 
     private:
 	uint32_t cut_off;
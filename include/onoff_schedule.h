@@ -0,0 +1,98 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ONOFF_SCHEDULE_H_
+#define ONOFF_SCHEDULE_H_
+#include <stdint.h>
+
+using namespace std;
+
+/*
+ * 	Stateless ON/OFF renewal process of the contents of a Shot Noise class.
+ *
+ * 	Each content starts ON at t=0 and alternates exponentially distributed ON periods (mean 'ton') and
+ * 	deterministic OFF periods ('toff'). Instead of storing the state and the next transition time of every
+ * 	content, the schedule of a content is re-derived on demand from the counter-based generator (ccn_rng)
+ * 	keyed by (seed, content ID, position in the schedule), so that the same content always sees the same ON periods
+ * 	and the memory footprint is O(1) per class.
+ *
+ * 	To avoid walking the whole schedule at every query, cycles are grouped in epochs of EPOCH cycles. The
+ * 	total ON time of an epoch is Gamma(EPOCH, ton) distributed and can be drawn directly. Inside the epoch
+ * 	containing the queried time, the ON time of the first half of a group of n cycles is a Beta(n/2, n/2)
+ * 	fraction of the ON time of the group (independent of it), so the cycle is found by bisection, with
+ * 	log2(EPOCH) splits drawn only along the path to the queried time. The resulting ON periods are exactly
+ * 	i.i.d. exponential.
+ *
+ * 	The groups of BLOCK cycles located by the last queries are kept in a small direct-mapped cache (by
+ * 	content ID): the next query of a content falling in the same block only needs log2(BLOCK) splits.
+ */
+class onoff_schedule
+{
+	public:
+		onoff_schedule(double _ton, double _toff, uint64_t _seed);
+
+		bool is_on(uint64_t contentID, double t) const;		// State of the content at time t.
+
+	private:
+		static const int EPOCH = 1024;						// Number of ON/OFF cycles per epoch.
+		static const int BLOCK = 64;						// Number of ON/OFF cycles per cached block.
+		static const int CACHE_SLOTS = 256;					// Slots of the cache of located blocks.
+
+		// Group of cycles of a content (node of the bisection of an epoch: 1 is the whole epoch,
+		// 2i and 2i+1 are the halves of i).
+		struct cycle_group
+		{
+			uint64_t epoch;
+			uint64_t node;
+			int cycles;
+			double start;			// Start time of the group.
+			double on_time;			// Total ON time of the group.
+		};
+
+		// Block located by a previous query, and the epoch containing it.
+		struct located_block
+		{
+			uint64_t contentID;		// UINT64_MAX if the slot is empty.
+			cycle_group block;
+			double epoch_start;
+			double epoch_on_time;
+		};
+
+		double gamma(uint64_t contentID, uint64_t epoch, uint64_t variate, double shape) const;
+		double split(uint64_t contentID, uint64_t epoch, uint64_t node, int cycles) const;
+		void bisect(uint64_t contentID, double t, int cycles, cycle_group &) const;
+
+		double ton;					// Mean ON time.
+		double toff;				// Deterministic OFF time.
+		uint64_t seed;				// Seed of the counter-based generator.
+
+		mutable located_block cache[CACHE_SLOTS];
+};
+#endif
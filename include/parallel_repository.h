@@ -39,10 +39,10 @@ using namespace std;
 
 class parallel_repository: public MonopathStrategyLayer{
     public:
-	virtual bool* get_decision(cMessage *);
-	bool *exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl;}
+	virtual interface_t get_decision(cMessage *);
+	interface_t exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl; return 0;}
     protected:
 	//Exploration and exploitation functions
-	bool *exploit(ccn_interest *);
+	interface_t exploit(ccn_interest *);
 };
 #endif
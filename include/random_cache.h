@@ -32,6 +32,7 @@
 #define R_CACHE_H_
 
 #include "base_cache.h"
+#include "ccn_rng.h"
 #include <boost/unordered_map.hpp>
 #include <omnetpp.h>
 #include <deque>
@@ -52,12 +53,15 @@ class random_cache: public base_cache{
 	void data_store(chunk_t);
 	virtual double get_tc_node(){;};
 	bool full();
+	bool eviction_candidate(chunk_t &);
 
 	//Deprecated
 	bool warmup();
 
     private:
 	deque<chunk_t> deq;
+	ccn_rng rng;		// Selection of the evicted element.
+	int next_victim;	// Position drawn in advance by eviction_candidate (-1 if none).
 	unordered_map<chunk_t, bool> cache;
 
 };
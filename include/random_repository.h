@@ -32,6 +32,7 @@
 #define RANDOM_REP_H_
 
 #include "MonopathStrategyLayer.h"
+#include "ccn_interest.h"
 
 using namespace std;
 class ccn_interest;
@@ -39,11 +40,11 @@ class ccn_interest;
 
 class random_repository : public MonopathStrategyLayer{
     public:
-	bool* get_decision(cMessage *);
-	bool *exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl;}
+	interface_t get_decision(cMessage *);
+	interface_t exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl; return 0;}
     protected:
 	//Exploration and exploitation functions
-	bool *exploit(ccn_interest *);
-	int random(vector<int>&);
+	interface_t exploit(ccn_interest *);
+	int random(repo_range);
 };
 #endif
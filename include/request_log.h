@@ -0,0 +1,99 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef REQUEST_LOG_H_
+#define REQUEST_LOG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * 	Binary log of the requests seen by a cache (one file per node, written when the
+ * 	request_log parameter of the cache is set, and read by scripts/belady.cc).
+ *
+ * 	Layout of the file:
+ * 		- header (request_log_header, 40 bytes);
+ * 		- records: uint64 [num_records], the requested chunks (chunk_t) in order of lookup.
+ *
+ * 	Records before warmup_records have been looked up before the last reset of the
+ * 	statistics (i.e., during the transient). All the fields are in native byte order.
+ */
+
+#pragma pack(push)
+#pragma pack(1)
+struct request_log_header{
+	char magic[4];				// "CCNR"
+	uint32_t version;
+	uint64_t num_records;
+	uint64_t warmup_records;	// Records looked up during the transient.
+	uint32_t node;				// Index of the cache.
+	uint32_t cache_size;		// Size of the cache [chunks].
+	uint32_t record_size;		// sizeof(uint64_t), checked at loading time.
+	uint32_t reserved;
+};
+#pragma pack(pop)
+
+#define REQUEST_LOG_MAGIC "CCNR"
+#define REQUEST_LOG_VERSION 1
+
+/*
+ * 	Writer of a request log. Records are buffered and written in blocks; the header
+ * 	is rewritten with the final counters by close().
+ */
+class request_log{
+	public:
+		request_log();
+		~request_log();
+
+		bool open(const char *file_name, uint32_t node, uint32_t cache_size, std::string &error);
+		bool close();
+
+		void append(uint64_t chunk)
+		{
+			buffer.push_back(chunk);
+			if (buffer.size() == BUFFER_RECORDS)
+				flush();
+		}
+
+		// Records appended so far are part of the transient.
+		void mark_warmup() {header.warmup_records = header.num_records + buffer.size();}
+
+	private:
+		static const size_t BUFFER_RECORDS = 1 << 16;
+
+		FILE *out;
+		request_log_header header;
+		std::vector<uint64_t> buffer;
+
+		void flush();
+};
+#endif
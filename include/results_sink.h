@@ -0,0 +1,120 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef RESULTS_SINK_H_
+#define RESULTS_SINK_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+/*
+ * 	Columnar results sink.
+ *
+ * 	Instead of issuing one recordScalar (and thus one line of a .sca file) per node and per metric,
+ * 	modules record their end-of-run metrics into a table (e.g., "node", "client", "global"), where the
+ * 	row is the index of the module and the column is the metric name. At the end of the run, all the
+ * 	tables are written inside a single binary file:
+ *
+ * 		- header: 	magic "CCNR", format version (uint32);
+ * 		- attrs: 	number of run attributes (uint32), followed by <key,value> string pairs;
+ * 		- schema: 	number of tables (uint32), followed, for each table, by its name, the number
+ * 					of rows (uint32), the number of columns (uint32) and the column names;
+ * 		- data:		for each table and for each column (in schema order), 'rows' doubles.
+ *
+ * 	Strings are stored as uint16 length + characters (no terminator). Missing cells are NaN.
+ * 	The class does not depend on OMNeT++, so that it can be linked by the off-line tools
+ * 	(see scripts/results_merge.cc).
+ */
+class results_sink{
+	public:
+		struct table{
+			uint32_t rows;
+			std::vector<std::string> columns;
+			std::vector< std::vector<double> > values;	// values[column][row]
+
+			table():rows(0){;}
+			int column_index(const std::string &) const;
+		};
+
+		static const uint32_t FORMAT_VERSION = 1;
+
+		results_sink():opened(false){;}
+
+		// The sink of the current run (modules of the same run share it).
+		static results_sink &get();
+
+		// Per-run life cycle.
+		void open(const std::string &file_name);
+		bool is_open() const {return opened;}
+		bool write();
+		void close();
+
+		void set_attribute(const std::string &key, const std::string &value);
+		void record(const std::string &table_name, uint32_t row, const std::string &column, double value);
+
+		// Off-line access (used by the merge tool).
+		bool read(const std::string &file_name);
+		bool write_to(const std::string &file_name) const;
+
+		std::map<std::string,std::string> attributes;
+		std::map<std::string,table> tables;
+
+		// Legacy scalar name, e.g., "p_hit[3]" (used when the sink is disabled).
+		static std::string indexed_name(const char *metric, int index);
+
+	private:
+		bool opened;
+		std::string file_name;
+};
+
+/*
+ * 	Records a per-module metric. If the results sink has been enabled for the current run, the
+ * 	value goes to the corresponding table; otherwise, the legacy "metric[index]" scalar is recorded.
+ *
+ * 	Parameters:
+ * 		- module: OMNeT++ component recording the metric (it must offer recordScalar).
+ * 		- table_name: table of the sink (e.g., "node", "client").
+ * 		- index: row of the table (i.e., index of the module).
+ * 		- metric: column of the table (i.e., name of the metric).
+ * 		- value: recorded value.
+ */
+template <class M>
+inline void record_result(M *module, const char *table_name, int index, const char *metric, double value)
+{
+	results_sink &sink = results_sink::get();
+	if (sink.is_open())
+		sink.record(table_name, index, metric, value);
+	else
+		module->recordScalar(results_sink::indexed_name(metric,index).c_str(), value);
+}
+
+#endif
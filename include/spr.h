@@ -32,6 +32,7 @@
 #define NEAREST_H_
 
 #include "MonopathStrategyLayer.h"
+#include "ccn_interest.h"
 
 class ccn_interest;
 using namespace std;
@@ -39,11 +40,11 @@ using namespace std;
 
 class spr : public MonopathStrategyLayer{
     public:
-	bool* get_decision(cMessage *);
-	bool *exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl;}
+	interface_t get_decision(cMessage *);
+	interface_t exploit_model(long m){cout << "NOT IMPLEMENTED!" << endl; return 0;}
     protected:
 	//Exploration and exploitation functions
-	bool *exploit(ccn_interest *);
-	int nearest(vector<int>&);
+	interface_t exploit(ccn_interest *);
+	int nearest(repo_range);
 };
 #endif
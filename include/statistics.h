@@ -61,6 +61,8 @@ using namespace boost;
 class statistics : public cSimpleModule{
 
 	public:
+		virtual ~statistics();
+
 		virtual void registerIcnChannel(cChannel* icn_channel);
 
 		void cacheFillNaive(); 					// Fill the caches with |cache_size| most popular contents.
@@ -88,10 +90,18 @@ class statistics : public cSimpleModule{
 	
 		void stability_has_been_reached();
 
+		// Results sink
+		void open_results_sink(string);
+		void record_global(const char*, double);		// Global metric (scalar + "global" table).
+		void record_class(int, const char*, double);	// Per-class metric of the Shot Noise Model.
+
 		// Added for hybridization
 		double calculate_phit_neigh (int, int, float**, float**, float**, double*, double, double, long, bool*, vector<vector<map<int,int> > > &);	// Calculate the phit of the neighbor using the conditional probabilities.
 		double MeanSquareDistance(uint32_t, double **, double **, int);
 		double calculate_phit_neigh_scalable (int, int, float**, float**, float**, double*, double, double, long, bool*, vector<map<int,int> > &);	// Calculate the phit of the neighbor using the conditional probabilities.
+		double model_insertion_prob(int, float**, float**, vector<int> &, long, float*);	// Per-content insertion probability (2-LRU and LCD).
+		void model_request_rates(long, double);				// Exogenous request processes of the model (IRM or Shot Noise).
+		double model_node_phit(float*, float*, long);		// Request-weighted hit probability of a node.
 
 
     private:
@@ -112,11 +122,19 @@ class statistics : public cSimpleModule{
 		int num_repos;
 
 		// Supported Meta-Caching Algorithms for Model Execution
-		typedef enum {LCE,fixP} policy;
+		typedef enum {LCE,fixP,twoLRU,leaveCopyDown} policy;
 		policy meta_cache;
 		const char *dpString;
 
 		double q;			// caching probability of the fixP algorithm;
+		uint32_t nc_size;	// name cache size of the 2-LRU algorithm;
+
+		// Request model (see model_request_rates)
+		bool onoff_model = false;
+		double *exo_rate = NULL;
+		float *on_mu = NULL;
+		float *on_toff = NULL;
+		float *on_duty = NULL;
 
 		// Stabilization parameters
 		double ts;						// Frequency of stable_check message.
@@ -155,8 +173,14 @@ class statistics : public cSimpleModule{
 
 		int sim_cycles = 1; 			// Track the number of simulation cycles
 		bool dynamic_tc = true;
+
+		// Accuracy of downscaled (ModelGraft) runs, reported at the end of the simulation.
+		bool mg_stable = false;			// The CV criterion has been met (full stability reached).
+		double mg_consistency = -1;		// Consistency error of the last Tc cycle (-1 if never checked).
                 
 		double cvThr;                   // Threshold to compare the Coefficient of Variation (CV) against.
         double consThr;                 // Consistency Check threshold; (default = 0.1)
+
+		bool results_pending = false;	// True when the results sink has to be written at the end of the run.
 };
 #endif
@@ -51,23 +51,44 @@ struct int_f
     }
 };
 
+// Read-only view over the FIB entries associated to a destination. It points into the
+// FIB storage (no copy), and it is valid until the FIB is rebuilt.
+struct fib_span
+{
+    const int_f *first;
+    const int_f *last;
+
+    fib_span(const int_f *f = NULL, const int_f *l = NULL):first(f),last(l){;}
+
+    const int_f *begin() const { return first; }
+    const int_f *end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const int_f &front() const { return *first; }
+    const int_f &operator[](size_t i) const { return first[i]; }
+};
+
 
 //	Basic strategy layer. It defines a get_decision function in order to handle the forwarding of Interest packets.
 class strategy_layer: public abstract_node{
     public:
 		/**
-		 * It returns an array of boolean values, one for each output gate.
-		 * The Interest is forwarded towards the gates whose ID corresponds the the positions of 1s
-		 * inside the array.
+		 * It returns a bitmask with one bit for each output gate (see __sface and __face in ccnsim.h).
+		 * The Interest is forwarded towards the gates whose ID corresponds to the positions of 1s
+		 * inside the bitmask. No memory is allocated.
 		 */
-		virtual bool* get_decision(cMessage *)=0;
+		virtual interface_t get_decision(cMessage *)=0;
 		
 		// Useful only for the execution of the model with NRR
-		virtual bool* exploit_model(long m) = 0;
+		virtual interface_t exploit_model(long m) = 0;
+
+		// Called when the PIT entry of 'chunk' is satisfied by a Data received through 'face', 'rtt'
+		// seconds after the Interest has been forwarded (adaptive strategies measure their faces with it).
+		virtual void interest_satisfied(chunk_t, int, double){;}
 
 		static ifstream fdist;
 		static ifstream frouting;
-		const vector<int_f> get_FIB_entries(int destination_node_index);
+		fib_span get_FIB_entries(int destination_node_index);
 		int get_out_interface(int destination_node);
     protected:
 		virtual void initialize();
@@ -82,8 +103,8 @@ class strategy_layer: public abstract_node{
 		void handleMessage(cMessage *);
 
 	private:
-		// Associates to each destination node, an output interface to reach it.
-		unordered_map <int ,vector<int_f> > FIB; 	
+		// Associates to each destination node (index of the vector), the output interfaces to reach it.
+		vector< vector<int_f> > FIB; 	
 		unordered_map <int, int> gatelu;	
 		int nodes;
 		// Messages for link failure/recovery and route re-computation.
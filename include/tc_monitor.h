@@ -0,0 +1,142 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TC_MONITOR_H_
+#define TC_MONITOR_H_
+
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+#include "results_sink.h"
+
+/*
+ * 	Sampled measurement of the characteristic time Tc of a cache.
+ *
+ * 	Caches keep the insertion (or last hit) time of each chunk inline in their own
+ * 	data structure, and pass the age of the evicted chunk to sample(). One eviction
+ * 	every 'every' is logged (0 disables the measurement) inside a streaming histogram
+ * 	with logarithmic bins (BINS_PER_DECADE bins per decade, from 10^MIN_EXP to 10^MAX_EXP
+ * 	seconds), so that both the mean and the distribution of Tc are available at the
+ * 	end of the run with constant memory and O(1) cost per sample.
+ */
+class tc_monitor
+{
+    public:
+		static const int BINS_PER_DECADE = 20;
+		static const int MIN_EXP = -3;
+		static const int MAX_EXP = 7;
+
+		tc_monitor():every(1),countdown(1),count(0),sum(0),bins((MAX_EXP - MIN_EXP) * BINS_PER_DECADE, 0){;}
+
+		void set_sampling(uint32_t e)
+		{
+			every = e;
+			countdown = e;
+		}
+
+		bool enabled() const {return every != 0;}
+
+		// Age of an evicted chunk [s].
+		void sample(double age)
+		{
+			if (every == 0 || --countdown != 0)
+				return;
+			countdown = every;
+
+			count++;
+			sum += age;
+			bins[bin(age)]++;
+		}
+
+		double samples() const {return count;}
+
+		// Average Tc (NaN without samples, as the former nodeTc/tcSamples).
+		double mean() const {return sum / count;}
+
+		/*
+		 * 	q-quantile of the measured Tc, interpolated (geometrically) inside the bin.
+		 */
+		double quantile(double q) const
+		{
+			if (count == 0)
+				return NAN;
+			double target = q * count;
+			double cum = 0;
+			for (unsigned b = 0; b < bins.size(); b++)
+			{
+				if (cum + bins[b] >= target && bins[b] > 0)
+				{
+					double frac = (target - cum) / bins[b];
+					return pow(10., MIN_EXP + (b + frac) / BINS_PER_DECADE);
+				}
+				cum += bins[b];
+			}
+			return pow(10., MAX_EXP);
+		}
+
+		void clear()
+		{
+			count = 0;
+			sum = 0;
+			bins.assign(bins.size(), 0);
+		}
+
+		// Records mean, quantiles and number of samples in the results sink.
+		template <class M>
+		void record(M *module, int index) const
+		{
+			record_result(module, "node", index, "tc_samples", count);
+			record_result(module, "node", index, "tc_mean", mean());
+			record_result(module, "node", index, "tc_p10", quantile(0.10));
+			record_result(module, "node", index, "tc_p50", quantile(0.50));
+			record_result(module, "node", index, "tc_p90", quantile(0.90));
+			record_result(module, "node", index, "tc_p99", quantile(0.99));
+		}
+
+    private:
+		uint32_t every;				// Log one eviction every 'every'.
+		uint32_t countdown;
+		uint64_t count;
+		double sum;
+		std::vector<uint64_t> bins;
+
+		unsigned bin(double age) const
+		{
+			if (age <= 0)
+				return 0;
+			double b = floor((log10(age) - MIN_EXP) * BINS_PER_DECADE);
+			if (b < 0)
+				return 0;
+			if (b >= bins.size())
+				return bins.size() - 1;
+			return (unsigned) b;
+		}
+};
+#endif
@@ -0,0 +1,90 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TINYLFU_POLICY_H_
+#define TINYLFU_POLICY_H_
+
+#include "decision_policy.h"
+#include "base_cache.h"
+#include "frequency_sketch.h"
+#include "results_sink.h"
+#include <vector>
+
+/*
+ * TinyLFU policy: every request seen by the cache is recorded inside a frequency sketch,
+ * and a retrieved chunk is admitted only if it is more popular than the one it would replace.
+ * When the cache is not full every chunk is admitted. If the replacement policy does not
+ * expose its eviction candidate, a chunk is admitted once it has been requested at least
+ * twice since the last aging, i.e., the same filtering done by the name cache of 2-LRU, with
+ * a few bits per content instead of a whole LRU cache of names.
+ */
+class TinyLFU: public DecisionPolicy
+{
+    public:
+	TinyLFU(base_cache *cache_p, uint64_t counters, uint64_t sample, bool use_doorkeeper):
+		sketch(counters, sample, use_doorkeeper),cache(cache_p),rejected(0)
+	{
+	}
+
+	virtual void after_lookup_action(chunk_t chunk)
+	{
+		sketch.increment(chunk);
+	}
+
+	virtual bool data_to_cache(ccn_data *data)
+	{
+		if (!cache->full())
+			return true;
+
+		unsigned f = sketch.estimate(data->getChunk());
+		bool admit;
+		chunk_t victim;
+		if (cache->eviction_candidate(victim))
+			admit = f > sketch.estimate(victim);
+		else
+			admit = f >= 2;
+
+		if (!admit)
+			rejected++;
+		return admit;
+	}
+
+	virtual void finish (int nodeIndex, base_cache* cache_p)
+	{
+		record_result(cache_p, "node", nodeIndex, "sketch_bytes", sketch.bytes());
+		record_result(cache_p, "node", nodeIndex, "tinylfu_rejected", rejected);
+	}
+
+    private:
+	frequency_sketch sketch;
+	base_cache *cache;
+	unsigned long rejected;	// Chunks not admitted because less popular than the eviction candidate.
+};
+#endif
@@ -0,0 +1,118 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TRACE_FILE_H_
+#define TRACE_FILE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/*
+ * 	Binary request trace (produced by scripts/trace_convert.cc from text/CSV logs).
+ *
+ * 	Layout of the file:
+ * 		- header (trace_header, 64 bytes);
+ * 		- content sizes: uint16 [num_contents], size (in chunks) of contents 1..num_contents;
+ * 		- client index: uint64 [num_clients+1], position of the first record of each client
+ * 		  (records of client k are in [index[k], index[k+1]) );
+ * 		- records: trace_record [num_records], grouped by client and sorted by timestamp.
+ *
+ * 	Content IDs are dense and ranked by decreasing popularity inside the trace (1 = most requested),
+ * 	like the IDs of the synthetic catalogs. Timestamps are relative to the first request [s].
+ * 	Records carry no size: like in the synthetic catalogs, every request downloads the whole content,
+ * 	whose size is the largest one requested inside the log.
+ * 	All the fields are in native byte order.
+ */
+
+#pragma pack(push)
+#pragma pack(1)
+struct trace_header{
+	char magic[4];				// "CCNT"
+	uint32_t version;
+	uint64_t num_records;
+	uint64_t num_contents;
+	uint32_t num_clients;
+	uint32_t record_size;		// sizeof(trace_record), checked at loading time.
+	uint64_t sizes_offset;
+	uint64_t index_offset;
+	uint64_t records_offset;
+	double duration;			// Timestamp of the last request [s].
+};
+
+struct trace_record{
+	double time;				// Request time [s].
+	uint32_t client;			// Client (i.e., section of the trace).
+	uint32_t content;			// Content ID (1..num_contents).
+};
+#pragma pack(pop)
+
+#define TRACE_MAGIC "CCNT"
+#define TRACE_VERSION 2
+
+/*
+ * 	Read-only memory mapping of a binary trace. Records are never copied nor parsed:
+ * 	readers walk the mapped array, and ask the kernel to load (prefetch) the pages of the
+ * 	next window of records, and to drop those already replayed (release).
+ */
+class trace_file{
+	public:
+		trace_file();
+		~trace_file();
+
+		bool open(const char *file_name, std::string &error);
+		void close();
+		bool is_open() const {return base != NULL;}
+
+		uint64_t get_num_records() const {return header->num_records;}
+		uint64_t get_num_contents() const {return header->num_contents;}
+		uint32_t get_num_clients() const {return header->num_clients;}
+		double get_duration() const {return header->duration;}
+
+		// Size [chunks] of the specified content (1..num_contents).
+		uint16_t get_content_size(uint64_t content) const {return sizes[content-1];}
+
+		// Records of the specified client.
+		const trace_record *section_begin(uint32_t client) const {return records + index[client];}
+		const trace_record *section_end(uint32_t client) const {return records + index[client+1];}
+		const trace_record *records_end() const {return records + header->num_records;}
+
+		void prefetch(const trace_record *from, const trace_record *to) const;
+		void release(const trace_record *from, const trace_record *to) const;
+
+	private:
+		void *base;
+		size_t length;
+		const trace_header *header;
+		const uint16_t *sizes;
+		const uint64_t *index;
+		const trace_record *records;
+};
+#endif
@@ -62,6 +62,11 @@ class ttl_cache:public base_cache
 
 		void extend_sim(); 			// Correct the Tc (TTL) value.
 
+		// Time-weighted occupancy.
+		void occupancy_change();			// To be called before any change of actual_size.
+		double occupancy_integral();		// Integral of actual_size since the beginning of the simulation.
+		void control_tc();					// One step of the adaptive Tc controller.
+
 		virtual void handleMessage(cMessage *);
 
 		void finish();
@@ -70,24 +75,31 @@ class ttl_cache:public base_cache
 
     private:
 		uint32_t actual_size = 0; 		//	Actual size of the cache (# objects).
-		double avg_as_curr;				//  Online avg of the actual cache size.
-		double avg_as_prev;
+		double avg_as_curr = 0;			//  Time-weighted avg of the actual cache size over the current cycle.
 		double target_cache;			// Target cache size of the downscaled system (C/Delta).
 		double time_extend;				// Start time of a new cycle
-		double avg_meas_time;			// Absolute measuring time of the last sample
-		double cycle_avg_meas_time;		// Relative measuring time of the last sample (i.e., avg_meas_time - time_extended)
-		double cycle_curr_time;			// Relative current time inside a cycle (i.e., simTime() - time_extended)
 
 
 		unordered_map<chunk_t, simtime_t> cache; 	// Implemented LRU cache.
 		cMessage *ttl_check_msg;
 		simtime_t ttl_check_timer;
 
-		uint32_t max_num_event_online_avg = 10;
-		uint32_t num_event_online_avg = 0;
+		// Occupancy integral (the average over the current cycle is the increase of the integral since time_extend).
+		double occ_integral = 0;		// Integral of actual_size up to occ_last.
+		double occ_last = 0;			// Time of the last change of actual_size.
+		double cycle_integral = 0;		// Value of the integral at the beginning of the cycle.
 
 		bool change_tc = true;			// Connected to the statistic module in order o change tc only where needed
-		bool conv_online_avg = false;
+
+		// Adaptive Tc controller (tc_control = "adaptive").
+		bool adaptive_tc = false;
+		double tc_tolerance;			// Relative occupancy error accepted by the convergence certificate.
+		uint32_t certify_windows;		// Consecutive windows within tolerance needed to certify convergence.
+		double win_start = 0;			// Start of the current measurement window.
+		double win_integral = 0;		// Value of the integral at the beginning of the window.
+		uint32_t ctrl_steps = 0;		// Number of corrections so far (step size of the stochastic approximation).
+		uint32_t ctrl_ok = 0;			// Consecutive windows within tolerance.
+		bool tc_certified = false;		// Tc has converged and is frozen.
 
 		uint32_t max_as = 0;
 
@@ -34,6 +34,8 @@
 #include "decision_policy.h"
 #include "base_cache.h"
 #include "lru_cache.h"
+#include "compact_name_cache.h"
+#include "results_sink.h"
 
 #include "error_handling.h"
 
@@ -42,12 +44,23 @@
  * 				 Name Cache (always with LRU replacement), in order to keep track of the IDs of the received Interest packets.
  * 				 In case of a HIT inside the Name Cache, the retrieved Data packet will be cached in the normal
  * 				 cache (i.e., the one that contains real contents); otherwise, it will be just forwarded back.
+ *
+ * 				 With 'generations' > 0, the Name Cache is a compact_name_cache (fingerprints inside a cuckoo
+ * 				 filter) aged every NC/generations insertions, instead of an exact LRU cache.
  */
 
 class Two_Lru: public DecisionPolicy
 {
     public:
-	Two_Lru(uint32_t cSize):ncSize(cSize){
+	Two_Lru(uint32_t cSize, int generations = 0):ncSize(cSize){
+		if (generations > 0)
+		{
+			name_cache = NULL;
+			compact = new compact_name_cache(ncSize, generations);
+			age_period = (ncSize + generations - 1) / generations;
+			age_times.assign(generations, 0);
+			return;
+		}
 		base_cache* bcPointer = new lru_cache();	// Create a new LRU cache that will act as a Name Cache.
 		name_cache = dynamic_cast<lru_cache *> (bcPointer);
 		name_cache->set_size(ncSize);}				// Set the size of the Name Cache.
@@ -82,24 +95,13 @@ class Two_Lru: public DecisionPolicy
 	// *** WITH TC MEASUREMENT ***
 	bool name_to_cache(chunk_t chunk)
 	{
+		if (compact)
+			return compact_name_to_cache(chunk);
+
 		if (name_cache->lookup_name(chunk))
 		{
-			// The ID is already present inside the Name Cache, so update its position and return True.
-			// As a consequence, the 'cacheable' flag inside the PIT will be set to 1.
-
-			// HIT - Update the timestamp of the relative content
-			if(nc_stable)
-			{
-				map<chunk_t, double>::iterator itHit = monitored_contents.find(chunk);
-				if(itHit == monitored_contents.end())
-				{
-					//cout << "Trying to update a non existing entry!\n";
-					//exit(1);
-				}
-				monitored_contents[chunk] = SIMTIME_DBL(simTime());
-				//cout << "NODE # " << getParentModule()->getIndex() << " :hit on content # " << elem << endl;
-			}
-
+			// The ID is already present inside the Name Cache, so update its position (and its hit time)
+			// and return True. As a consequence, the 'cacheable' flag inside the PIT will be set to 1.
 			return true;
 		}
 		else
@@ -107,41 +109,11 @@ class Two_Lru: public DecisionPolicy
 			// The ID is NOT present inside the Name Cache, so insert it and return False.
 			// As a consequence, the 'cacheable' flag inside the PIT will be set to 0.
 
-			// MISS - Insert the new element and log the Tc of the LRU one.
-			if(nc_stable)
+			// MISS - Log the Tc of the LRU element that will be discarded (time since its insertion or last hit).
+			if(nc_stable && current_size == ncSize)
 			{
-				if(current_size == ncSize)  // Log the Tc of the LRU elem that will be discarded
-				{
-					chunk_t k = (name_cache->get_lru())->k;
-					map<chunk_t, double>::iterator it = monitored_contents.find(k);
-					if(it == monitored_contents.end())
-					{
-						//cout << simTime() << " :Cannot log Tc: entry for content # " << k << " is not present!\n";
-						//exit(1);
-					}
-					else
-					{
-						double Tc  = SIMTIME_DBL(simTime()) - monitored_contents[k];
-						monitored_contents.erase(k);
-						//int nodeId = getParentModule()->getIndex();
-						//cout << simTime() << "\tNODE\t" << nodeId << "\tContent\t" << k << "\tTc\t" << Tc << endl;
-						tc_name_cache += Tc;
-						tc_name_samples++;
-					}
-				}
-
-				// Insert the new element inside the map
-				map<chunk_t, double>::iterator it = monitored_contents.find(chunk);
-				if(it == monitored_contents.end())
-				{
-					monitored_contents[chunk] = SIMTIME_DBL(simTime());
-					//cout << "NODE # " << getParentModule()->getIndex() << " :caching content # " << elem << endl;
-				}
-				else
-				{
-					cout << "The entry is present despite the previous miss event!\n";
-					exit(1);
-				}
+				tc_name_cache += SIMTIME_DBL(simTime()) - SIMTIME_DBL(name_cache->get_lru()->hit_time);
+				tc_name_samples++;
 			}
 
 			if(current_size < ncSize)
@@ -153,11 +125,21 @@ class Two_Lru: public DecisionPolicy
 	}
 
 
+	virtual void finish (int nodeIndex, base_cache* cache_p)
+	{
+		if (!compact)
+			return;
+		record_result(cache_p, "node", nodeIndex, "name_fp_rate", compact->fp_rate());
+		record_result(cache_p, "node", nodeIndex, "name_cache_bytes", compact->bytes());
+		record_result(cache_p, "node", nodeIndex, "name_cache_overflows", compact->get_overflows());
+	}
+
+
 	lru_cache* name_cache;
+	compact_name_cache* compact = NULL;
 
 	double tc_name_cache = 0;
 	double tc_name_samples = 0;
-	map < chunk_t, double> monitored_contents;
 
 	bool nc_stable = false;
 
@@ -166,6 +148,40 @@ class Two_Lru: public DecisionPolicy
 	//lru_cache* name_cache;
 	uint32_t ncSize;		// Size of the Name Cache in terms of number of content IDs.
 	uint32_t current_size = 0;
+
+	// Compact Name Cache.
+	uint32_t age_period = 0;		// Insertions between two agings.
+	uint32_t insertions = 0;
+	uint64_t agings = 0;
+	vector<double> age_times;		// Time of the last 'generations' agings.
+
+	/*
+	 * 	2-LRU decision with the compact Name Cache. The Tc of the Name Cache is the time needed to
+	 * 	age all the generations, i.e., the time spent by a non-refreshed ID inside the filter.
+	 */
+	bool compact_name_to_cache(chunk_t chunk)
+	{
+		if (compact->lookup(chunk))
+			return true;
+
+		compact->insert(chunk);
+		if (++insertions >= age_period)
+		{
+			insertions = 0;
+			compact->age();
+
+			double now = SIMTIME_DBL(simTime());
+			unsigned i = agings % age_times.size();
+			if (nc_stable && agings >= age_times.size())
+			{
+				tc_name_cache += now - age_times[i];
+				tc_name_samples++;
+			}
+			age_times[i] = now;
+			agings++;
+		}
+		return false;
+	}
 };
 #endif
 
@@ -35,6 +35,8 @@
 #include "base_cache.h"
 //#include "lru_cache.h"
 #include "ttl_name_cache.h"
+#include "compact_name_cache.h"
+#include "results_sink.h"
 
 #include "error_handling.h"
 
@@ -43,13 +45,25 @@
  * 				 Name Cache (always with TTL replacement), in order to keep track of the IDs of the received Interest packets.
  * 				 In case of a HIT inside the Name Cache, the retrieved Data packet will be cached in the normal
  * 				 cache (i.e., the one that contains real contents); otherwise, it will be just forwarded back.
+ *
+ * 				 With 'generations' > 0, the Name Cache is a compact_name_cache of 'slots' names, aged
+ * 				 every Tc/generations seconds, instead of an exact TTL cache.
  */
 
 class Two_TTL: public DecisionPolicy
 {
     public:
 	// WITH TTL
-	Two_TTL(double tc_nameNode):tcName(tc_nameNode){
+	Two_TTL(double tc_nameNode, uint32_t slots = 0, int generations = 0):tcName(tc_nameNode){
+			if (generations > 0)
+			{
+				name_cache = NULL;
+				compact = new compact_name_cache(slots, generations);
+				num_generations = generations;
+				age_period = tcName / generations;
+				next_age = SIMTIME_DBL(simTime()) + age_period;
+				return;
+			}
 			base_cache* bcPointer = new ttl_name_cache();	// Create a new TTL cache that will act as a Name Cache.
 			name_cache = dynamic_cast<ttl_name_cache *> (bcPointer);
 			name_cache->initialize_name_cache(tcName);}				// Set the size of the Name Cache.
@@ -62,6 +76,11 @@ class Two_TTL: public DecisionPolicy
 
 	void set_target_name_cache(double tnc)
 	{
+		if (compact)
+		{
+			target_name_cache = tnc;
+			return;
+		}
 		name_cache->set_target_name_cache(tnc);
 	}
 
@@ -71,6 +90,13 @@ class Two_TTL: public DecisionPolicy
 	 */
 	void check_name_cache()
 	{
+		if (compact)
+		{
+			age_compact();
+			occupancy_sum += compact->size();	// Periodic sample of the occupancy, used by extend_sim().
+			occupancy_samples++;
+			return;
+		}
 		name_cache->check_cache();
 	}
 
@@ -80,6 +106,15 @@ class Two_TTL: public DecisionPolicy
 	 */
 	bool name_to_cache(chunk_t chunk)
 	{
+		if (compact)
+		{
+			age_compact();
+			if (compact->lookup(chunk))
+				return true;
+			compact->insert(chunk);
+			return false;
+		}
+
 		if (name_cache->lookup_name(chunk))
 		{
 			// The ID is already present inside the Name Cache, so update its position and return True.
@@ -102,19 +137,68 @@ class Two_TTL: public DecisionPolicy
 	{
 		//name_cache->flush();
 		//name_cache->tc_name_node = newTcName;
+		if (compact)
+		{
+			// Same correction of the exact TTL name cache, based on the average occupancy.
+			double avg_size = occupancy_samples ? occupancy_sum / occupancy_samples : 0;
+			if (target_name_cache > 0 && avg_size > 0 && fabs(target_name_cache - avg_size)/target_name_cache > 0.1)
+				tcName = tcName * target_name_cache / avg_size;
+			age_period = tcName / num_generations;
+			next_age = SIMTIME_DBL(simTime()) + age_period;
+			occupancy_sum = 0;
+			occupancy_samples = 0;
+			compact->flush();
+			return;
+		}
 		name_cache->extend_sim();
 	}
 
 	void finish_name_cache()
 	{
+		if (compact)
+		{
+			cout << "NODE # " << compact_node << " NAME CACHE ONLINE AVG ACTUAL SIZE: " << (occupancy_samples ? occupancy_sum / occupancy_samples : 0) << endl;
+			cout << "NODE # " << compact_node << " NAME CACHE Tc: " << tcName << endl;
+			return;
+		}
 		name_cache->finish_name_cache();
 	}
 
+	virtual void finish (int nodeIndex, base_cache* cache_p)
+	{
+		if (!compact)
+			return;
+		compact_node = nodeIndex;		// finish_name_cache() is called afterwards by the ttl_cache.
+		record_result(cache_p, "node", nodeIndex, "name_fp_rate", compact->fp_rate());
+		record_result(cache_p, "node", nodeIndex, "name_cache_bytes", compact->bytes());
+		record_result(cache_p, "node", nodeIndex, "name_cache_overflows", compact->get_overflows());
+	}
+
     private:
 	//lru_cache* name_cache;
 	//uint32_t ncSize;		// Size of the Name Cache in terms of number of content IDs.
 	ttl_name_cache* name_cache;
 	double tcName;			// Tc of the name cache
+
+	// Compact Name Cache.
+	compact_name_cache* compact = NULL;
+	int num_generations = 0;
+	double age_period = 0;	// Seconds between two agings.
+	double next_age = 0;
+	double target_name_cache = 0;
+	double occupancy_sum = 0;
+	uint64_t occupancy_samples = 0;
+	int compact_node = 0;
+
+	void age_compact()
+	{
+		double now = SIMTIME_DBL(simTime());
+		while (now >= next_age)
+		{
+			compact->age();
+			next_age += age_period;
+		}
+	}
 };
 #endif
 
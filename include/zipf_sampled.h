@@ -34,6 +34,7 @@
 #include <omnetpp.h>
 #include <vector>
 #include "error_handling.h"
+#include "ccn_rng.h"
 #if OMNETPP_VERSION < 0x0500
     #include <csimplemodule.h>
 #else
@@ -145,10 +146,16 @@ class zipf_sampled {
 
 
         /** Generate one integral number in the range [1, numberOfElements].
-         * @param random random generator to use
+         * @param rng random generator to use (NULL means the OMNeT++ RNG 0 of the current context)
          * @return generated integral number in the range [1, numberOfElements]
          */
-        unsigned long long sample();
+        unsigned long long sample(ccn_rng *rng = NULL);
+
+        /** Generate n integral numbers in the range [1, numberOfElements] (same as n calls to sample(&rng)).
+         * @param rng random generator to use
+         * @param out array of (at least) n elements
+         */
+        void sample(ccn_rng &rng, unsigned long long *out, size_t n);
 
 
         /**
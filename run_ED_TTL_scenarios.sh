@@ -55,6 +55,8 @@
 
 ## TTL ##
 ./runsim_script_ED_TTL.sh tree 8 1 spr lce ttl 1 1e5 1e5 1e8 1e8 20.0 IRM IRM 0 0 cold naive 0.75 1e4
+## TTL with automatic selection of Delta (starting from C/10, halved until the CV and consistency criteria are met) ##
+#./runsim_script_ModelGraft_autoDelta.sh tree 8 1 spr lce ttl 1 1e5 1e5 1e8 1e8 20.0 IRM IRM 0 0 cold naive 0.75 auto
 #./runsim_script_ED_TTL.sh tree 8 1 spr lcd ttl 1 1e5 1e5 1e8 1e8 20.0 IRM IRM 0 0 cold naive 0.75 1e4
 #./runsim_script_ED_TTL.sh tree 8 1 spr fix0.1 ttl 1 1e5 1e5 1e8 1e8 20.0 IRM IRM 0 0 cold naive 0.75 1e4
 #./runsim_script_ED_TTL.sh ndntestbed_26 8 1 spr two_lru ttl 1 1e5 1e5 1e8 1e8 20.0 IRM IRM 0 0 cold naive 0.75 1e4
@@ -0,0 +1,112 @@
+#!/bin/bash
+#
+# Automatic selection of the downsizing factor (Delta) of ModelGraft (TTL-based) simulations.
+#
+# Same parameters as runsim_script_ED_TTL.sh, with the #Down parameter interpreted as the initial
+# (i.e., most aggressive) Delta, or 'auto' to start from the maximum one allowed by the TTL caches (C/10).
+# Each candidate Delta is simulated with runsim_script_ED_TTL.sh; if any run fails the CV (stability) or the
+# consistency criteria ('cvThr' and 'consThr' in the .ini file), Delta is halved and the scenario is simulated again.
+# The first Delta passing the criteria in all the runs (or Delta = 1) is the selected one.
+#
+#-Parameters:
+#Topo #Clients #Repos #FS #MC #RS #Alpha #CacheDim #NameCacheDim #Catalog #Req #Lambda #Client #ContDistr #Toff #Runs #Start #Fill #Yotta #Down|auto (#TcFile #TcNameFile)
+
+####### DIRECTORIES ######
+infoDir=infoSim
+logDir=logs
+##########################
+
+parameters=( "$@" )
+
+Topology=${parameters[0]}
+NumClients=${parameters[1]}
+NumRepos=${parameters[2]}
+ForwStr=${parameters[3]}
+MetaCaching=${parameters[4]}
+ReplStr=${parameters[5]}
+Alpha=${parameters[6]}
+CacheDim=${parameters[7]}
+TotalCont=${parameters[9]}
+TotalReq=${parameters[10]}
+Lambda=${parameters[11]}
+ClientType=${parameters[12]}
+Toff=${parameters[14]}
+runs=${parameters[15]}
+startType=${parameters[16]}
+fillType=${parameters[17]}
+checkNodes=${parameters[18]}
+down=${parameters[19]}
+
+if [[ $ReplStr != "ttl" ]]
+	then
+	echo "The automatic selection of Delta is available only for TTL-based (ModelGraft) simulations."
+	exit 1
+fi
+
+if [[ $MetaCaching == "two_lru" ]] || [[ $MetaCaching == "two_ttl" ]]
+	then
+	NameCacheDim=${parameters[8]}
+else
+	NameCacheDim="0"
+fi
+
+# Maximum Delta allowed by the TTL caches (see ttl_cache.cc).
+CacheDimValue=`echo ${CacheDim} | sed -e 's/[eE]+*/\\*10\\^/'`
+maxDelta=$(echo "$CacheDimValue / 10" | bc)
+
+if [[ $down == "auto" ]]
+	then
+	delta=$maxDelta
+else
+	delta=$(echo "`echo ${down} | sed -e 's/[eE]+*/\\*10\\^/'`" | bc)
+	if (( delta > maxDelta ))
+		then
+		delta=$maxDelta
+	fi
+fi
+if (( delta < 1 ))
+	then
+	delta=1
+fi
+
+summary=${infoDir}/AUTO_DELTA_T_${Topology}_NumCl_${NumClients}_NumRep_${NumRepos}_FS_${ForwStr}_MC_${MetaCaching}_RS_${ReplStr}_C_${CacheDim}_NC_${NameCacheDim}_M_${TotalCont}_Req_${TotalReq}_Lam_${Lambda}_A_${Alpha}_CT_${ClientType}_ToffMult_${Toff}_Start_${startType}_Fill_${fillType}_ChNodes_${checkNodes}
+echo -e "Delta\tResult\tMaxConsistency\tMaxCycles\tCPU_end[s]" > ${summary}
+
+while true
+do
+	echo "*** AUTO DELTA: simulating Delta = ${delta} ***"
+	./runsim_script_ED_TTL.sh "${parameters[@]:0:19}" ${delta} "${parameters[@]:20}"
+
+	outString=TTL_T_${Topology}_NumCl_${NumClients}_NumRep_${NumRepos}_FS_${ForwStr}_MC_${MetaCaching}_RS_${ReplStr}_C_${CacheDim}_NC_${NameCacheDim}_M_${TotalCont}_Req_${TotalReq}_Lam_${Lambda}_A_${Alpha}_CT_${ClientType}_ToffMult_${Toff}_Start_${startType}_Fill_${fillType}_ChNodes_${checkNodes}_Down_${delta}
+
+	# A run passes if it printed a PASSED check (runs that never stabilize do not reach the check at all).
+	result="PASSED"
+	maxCons=0
+	maxCycles=0
+	for i in `seq 0 $runs`
+	do
+		check=$(grep "MODELGRAFT CHECK" ${logDir}/${outString}_run\=${i}.out | tail -n 1)
+		if [[ $check != *PASSED* ]]
+			then
+			result="FAILED"
+		fi
+		if [ -n "$check" ]
+			then
+			maxCons=$(echo "$check" | awk -v m=$maxCons '{print ($7 > m) ? $7 : m}')
+			maxCycles=$(echo "$check" | awk -v m=$maxCycles '{print ($9 > m) ? $9 : m}')
+		fi
+	done
+	cpuEnd=$(head -n 1 ${infoDir}/CPU_${outString})
+
+	echo -e "${delta}\t${result}\t${maxCons}\t${maxCycles}\t${cpuEnd}" >> ${summary}
+	echo "*** AUTO DELTA: Delta = ${delta} -> ${result} (consistency error ${maxCons}, cycles ${maxCycles}) ***"
+
+	if [[ $result == "PASSED" ]] || (( delta == 1 ))
+		then
+		break
+	fi
+	delta=$(( delta / 2 ))
+done
+
+echo "*** AUTO DELTA: selected Delta = ${delta} (${result}) ***"
+echo -e "Selected\t${delta}\t${result}" >> ${summary}
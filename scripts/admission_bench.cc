@@ -0,0 +1,324 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * 	Memory and throughput of the TinyLFU admission (DS = "tinylfu") against the 2-LRU name
+ * 	cache (DS = "two_lru", exact name cache), replayed on a single LRU cache node.
+ *
+ * 	Compile it (from the root folder of ccnSim) with:
+ * 		g++ -O2 -Iinclude -o admission_bench scripts/admission_bench.cc
+ *
+ * 	Usage:
+ * 		admission_bench [-M catalog] [-a alpha] [-C cache_size] [-N name_cache_size] [-R requests] [-s seed] [-d doorkeeper]
+ *
+ * 	Defaults are the ones of ED_TTL-omnetpp.ini (M = 1e6, alpha = 1, C = 1e4), with NC = C and
+ * 	R = 2e7 IRM requests and the doorkeeper on (-d 0 turns it off). Both policies see the same request stream, in the same order as inside
+ * 	the simulator: the admission structure is updated at the Interest (after_lookup_action for
+ * 	TinyLFU, name_to_cache for 2-LRU), and the Data of a miss is stored if it is admitted.
+ *
+ * 	The TinyLFU sketch is include/frequency_sketch.h, with the default sizing of base_cache
+ * 	(4*C counters per row, aging every 10*C requests, doorkeeper on). The content store and the
+ * 	exact name cache replicate lru_cache (lru_pos list + boost::unordered_map), so that their
+ * 	heap footprint is the one of the simulator. Memory is measured by counting the bytes
+ * 	allocated through operator new; time is the wall clock time of the replay (the request
+ * 	stream is generated beforehand and it is not timed).
+ */
+#include "frequency_sketch.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <chrono>
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+
+using namespace std;
+
+// *** Heap accounting ***
+static size_t live_bytes = 0;
+
+void *operator new(size_t size)
+{
+	size_t *p = (size_t *) malloc(size + sizeof(size_t));
+	if (!p)
+		throw std::bad_alloc();
+	*p = size;
+	live_bytes += size;
+	return p + 1;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (!ptr)
+		return;
+	size_t *p = (size_t *) ptr - 1;
+	live_bytes -= *p;
+	free(p);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+// *** LRU list indexed by a hash map (as lru_cache) ***
+struct lru_pos
+{
+	lru_pos *older;
+	lru_pos *newer;
+	uint64_t k;
+	int64_t hit_time;		// simtime_t
+	double cost;
+};
+
+class lru_list
+{
+	public:
+		lru_list(uint64_t c):capacity(c),lru(0),mru(0){;}
+		~lru_list()
+		{
+			while (lru)
+			{
+				lru_pos *p = lru;
+				lru = lru->newer;
+				delete p;
+			}
+		}
+
+		bool full() const {return map.size() >= capacity;}
+		uint64_t victim() const {return lru->k;}
+
+		// Lookup; a hit moves the element to the MRU position.
+		bool lookup(uint64_t k)
+		{
+			boost::unordered_map<uint64_t, lru_pos*>::iterator it = map.find(k);
+			if (it == map.end())
+				return false;
+			lru_pos *p = it->second;
+			if (p != mru)
+			{
+				if (p->older)
+					p->older->newer = p->newer;
+				else
+					lru = p->newer;
+				p->newer->older = p->older;
+				p->older = mru;
+				p->newer = 0;
+				mru->newer = p;
+				mru = p;
+			}
+			return true;
+		}
+
+		// Insertion of an absent element at the MRU position (the LRU one is evicted if full).
+		void store(uint64_t k)
+		{
+			lru_pos *p;
+			if (full())
+			{
+				p = lru;
+				map.erase(p->k);
+				lru = p->newer;
+				if (lru)
+					lru->older = 0;
+				else
+					mru = 0;
+			}
+			else
+				p = new lru_pos();
+			p->k = k;
+			p->older = mru;
+			p->newer = 0;
+			if (mru)
+				mru->newer = p;
+			else
+				lru = p;
+			mru = p;
+			map[k] = p;
+		}
+
+	private:
+		uint64_t capacity;
+		lru_pos *lru;
+		lru_pos *mru;
+		boost::unordered_map<uint64_t, lru_pos*> map;
+};
+
+// *** Workload ***
+static uint64_t splitmix64(uint64_t &state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static void zipf_requests(uint64_t catalog, double alpha, uint64_t n, uint64_t seed, vector<uint64_t> &out)
+{
+	vector<double> cdf(catalog);
+	double sum = 0;
+	for (uint64_t k = 0; k < catalog; k++)
+		cdf[k] = (sum += pow(k + 1., -alpha));
+	out.resize(n);
+	uint64_t state = seed;
+	for (uint64_t i = 0; i < n; i++)
+	{
+		double u = (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0) * sum;
+		out[i] = (lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()) + 1;
+	}
+}
+
+struct bench_result
+{
+	double hit;
+	double ns_per_request;
+	size_t admission_bytes;		// Heap of the admission structure.
+	size_t total_bytes;			// Heap of admission structure and content store.
+};
+
+static bench_result run_tinylfu(const vector<uint64_t> &req, uint64_t C, bool doorkeeper)
+{
+	bench_result r;
+	size_t before = live_bytes;
+	frequency_sketch *sketch = new frequency_sketch(4 * C, 10 * C, doorkeeper);
+	r.admission_bytes = live_bytes - before;
+	lru_list *cache = new lru_list(C);
+
+	uint64_t hits = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < req.size(); i++)
+	{
+		uint64_t k = req[i];
+		sketch->increment(k);
+		if (cache->lookup(k))
+			hits++;
+		else if (!cache->full() || sketch->estimate(k) > sketch->estimate(cache->victim()))
+			cache->store(k);
+	}
+	double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+	r.total_bytes = live_bytes - before;
+	r.hit = hits * 1. / req.size();
+	r.ns_per_request = elapsed / req.size();
+	delete cache;
+	delete sketch;
+	return r;
+}
+
+static bench_result run_two_lru(const vector<uint64_t> &req, uint64_t C, uint64_t NC)
+{
+	bench_result r;
+	size_t before = live_bytes;
+	lru_list *names = new lru_list(NC);
+	lru_list *cache = new lru_list(C);
+
+	uint64_t hits = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < req.size(); i++)
+	{
+		uint64_t k = req[i];
+		bool cacheable = names->lookup(k);
+		if (!cacheable)
+			names->store(k);
+		if (cache->lookup(k))
+			hits++;
+		else if (cacheable)
+			cache->store(k);
+	}
+	double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+	r.total_bytes = live_bytes - before;
+	delete cache;
+	r.admission_bytes = live_bytes - before;	// Only the name cache is left.
+	r.hit = hits * 1. / req.size();
+	r.ns_per_request = elapsed / req.size();
+	delete names;
+	return r;
+}
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-M catalog] [-a alpha] [-C cache_size] [-N name_cache_size] [-R requests] [-s seed] [-d doorkeeper]" << endl;
+}
+
+int main(int argc, char **argv)
+{
+	double M = 1e6, alpha = 1, C = 1e4, NC = -1, R = 2e7, seed = 1, doorkeeper = 1;
+
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg += 2)
+	{
+		if (arg + 1 >= argc)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+		if (strcmp(argv[arg], "-M") == 0)
+			M = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-a") == 0)
+			alpha = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-C") == 0)
+			C = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-N") == 0)
+			NC = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-R") == 0)
+			R = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-s") == 0)
+			seed = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-d") == 0)
+			doorkeeper = atof(argv[arg+1]);
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (NC < 0)
+		NC = C;
+	if (arg < argc || M < 1 || C < 1 || NC < 1 || R < 1 || alpha <= 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	vector<uint64_t> req;
+	zipf_requests((uint64_t) M, alpha, (uint64_t) R, (uint64_t) seed, req);
+
+	bench_result t = run_tinylfu(req, (uint64_t) C, doorkeeper != 0);
+	bench_result l = run_two_lru(req, (uint64_t) C, (uint64_t) NC);
+
+	cout << "M=" << M << " alpha=" << alpha << " C=" << C << " NC=" << NC << " R=" << R << " doorkeeper=" << doorkeeper << endl;
+	cout << "DS\tp_hit\tns/request\tadmission_bytes\tnode_bytes" << endl;
+	cout << "tinylfu\t" << t.hit << "\t" << t.ns_per_request << "\t" << t.admission_bytes << "\t" << t.total_bytes << endl;
+	cout << "two_lru\t" << l.hit << "\t" << l.ns_per_request << "\t" << l.admission_bytes << "\t" << l.total_bytes << endl;
+	return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * 	Offline optimal (Belady's MIN) hit ratio of the request logs written by the caches
+ * 	(see the request_log parameter of base_cache, and include/request_log.h for the format).
+ *
+ * 	Compile it (from the root folder of ccnSim) with:
+ * 		g++ -O2 -Iinclude -o belady scripts/belady.cc
+ *
+ * 	Usage:
+ * 		belady [-c cache_size] [-t tmp_dir] log_file [log_file ...]
+ *
+ * 		- cache_size: size of the cache [chunks] (default: the size of the logged cache);
+ * 		- tmp_dir: folder of the scratch file holding the next-use index (default: the folder
+ * 		  of each log).
+ *
+ * 	For each log, the position of the next request of the same chunk is computed with a
+ * 	single backward pass and stored in a memory mapped scratch file (8 bytes per request),
+ * 	so that logs larger than the memory can be processed; the forward pass keeps in memory
+ * 	only the cached chunks and a heap of their next uses (O(cache_size)). The cache is
+ * 	allowed not to store a retrieved chunk (like meta-caching does), so the chunk requested
+ * 	farthest in the future among the cached ones and the incoming one is discarded.
+ * 	The hit ratio is computed on the requests logged after the transient, while the
+ * 	transient requests are used to fill the cache.
+ *
+ * 	Note that the requests seen by a cache depend on the caches downstream: the bound is
+ * 	the one of each node given the stream that it received during the simulation.
+ */
+#include "request_log.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+using namespace std;
+
+static const uint64_t NEVER = ~(uint64_t) 0;		// Next use of a chunk which is not requested anymore.
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-c cache_size] [-t tmp_dir] log_file [log_file ...]" << endl;
+}
+
+struct belady_result{
+	uint64_t requests;		// Requests after the transient.
+	uint64_t hits;
+};
+
+/*
+ * 	Map a file of the given length (read-only if length is 0, i.e., the length of the file).
+ */
+static void *map_file(const string &name, size_t &length, bool writable, string &error)
+{
+	int fd = writable ? open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600) : open(name.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		error = "Impossible to open " + name;
+		return NULL;
+	}
+	if (writable)
+	{
+		unlink(name.c_str());		// Scratch file: removed as soon as it is unmapped.
+		if (ftruncate(fd, length) != 0)
+		{
+			close(fd);
+			error = "Impossible to allocate the scratch file " + name;
+			return NULL;
+		}
+	}
+	else
+	{
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+		{
+			close(fd);
+			error = "Impossible to read " + name;
+			return NULL;
+		}
+		length = st.st_size;
+	}
+	if (length == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	void *p = mmap(NULL, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);		// The mapping keeps the file referenced.
+	if (p == MAP_FAILED)
+	{
+		error = "Impossible to map " + name;
+		return NULL;
+	}
+	return p;
+}
+
+/*
+ * 	Belady's MIN on records [0, n), given the next-use index. Hits are counted from
+ * 	record 'warmup' on.
+ */
+static belady_result simulate(const uint64_t *records, const uint64_t *next, uint64_t n, uint64_t warmup, uint64_t size)
+{
+	belady_result r;
+	r.requests = n - warmup;
+	r.hits = 0;
+	if (size == 0)
+		return r;
+
+	// Max-heap of (next use, chunk) of the cached chunks. When a cached chunk is requested
+	// at position i, its entry (i, chunk) becomes stale and a new one is pushed: stale
+	// entries are exactly those whose next use has already passed, hence they are never
+	// on top of the heap, and they are purged when the heap doubles.
+	typedef pair<uint64_t, uint64_t> heap_entry;
+	vector<heap_entry> heap;
+	heap.reserve(2 * size + 1);
+	boost::unordered_set<uint64_t> cached;
+	cached.reserve(size + 1);
+
+	for (uint64_t i = 0; i < n; i++)
+	{
+		uint64_t chunk = records[i];
+		if (cached.find(chunk) != cached.end())
+		{
+			if (i >= warmup)
+				r.hits++;
+		}
+		else
+		{
+			if (next[i] == NEVER)
+				continue;		// Storing it would not give any hit.
+			if (cached.size() == size)
+			{
+				if (heap.front().first <= next[i])
+					continue;	// The incoming chunk is the one requested farthest in the future.
+				cached.erase(heap.front().second);
+				pop_heap(heap.begin(), heap.end());
+				heap.pop_back();
+			}
+			cached.insert(chunk);
+		}
+
+		heap.push_back(heap_entry(next[i], chunk));
+		push_heap(heap.begin(), heap.end());
+
+		if (heap.size() > 2 * size)
+		{
+			size_t k = 0;
+			for (size_t j = 0; j < heap.size(); j++)
+				if (heap[j].first > i)
+					heap[k++] = heap[j];
+			heap.resize(k);
+			make_heap(heap.begin(), heap.end());
+		}
+	}
+	return r;
+}
+
+int main(int argc, char **argv)
+{
+	int64_t cache_size = -1;
+	string tmp_dir;
+	int arg = 1;
+
+	for (; arg < argc && argv[arg][0] == '-'; arg += 2)
+	{
+		if (arg + 1 >= argc)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+		if (strcmp(argv[arg], "-c") == 0)
+			cache_size = atoll(argv[arg+1]);
+		else if (strcmp(argv[arg], "-t") == 0)
+			tmp_dir = argv[arg+1];
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (arg >= argc || cache_size < -1)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	uint64_t total_requests = 0, total_hits = 0;
+	int logs = argc - arg;
+	cout << "node\tC\trequests\thits\tp_hit" << endl;
+	for (; arg < argc; arg++)
+	{
+		string name = argv[arg];
+		string error;
+		size_t length = 0;
+		const char *base = (const char *) map_file(name, length, false, error);
+		if (base == NULL && error.empty())
+			error = name + " is empty";
+		if (base == NULL)
+		{
+			cerr << error << endl;
+			return 2;
+		}
+
+		const request_log_header *h = (const request_log_header *) base;
+		if (length < sizeof(request_log_header) || memcmp(h->magic, REQUEST_LOG_MAGIC, sizeof(h->magic)) != 0 ||
+				h->version != REQUEST_LOG_VERSION || h->record_size != sizeof(uint64_t))
+			error = name + " is not a ccnSim request log (or it has been written by a different version)";
+		else if (sizeof(request_log_header) + h->num_records * sizeof(uint64_t) > length)
+			error = name + " is truncated (was the simulation interrupted?)";
+		if (!error.empty())
+		{
+			cerr << error << endl;
+			return 2;
+		}
+
+		uint64_t n = h->num_records;
+		uint64_t size = cache_size >= 0 ? (uint64_t) cache_size : h->cache_size;
+		const uint64_t *records = (const uint64_t *) (base + sizeof(request_log_header));
+		belady_result r;
+		r.requests = r.hits = 0;
+
+		if (n > 0)
+		{
+			// Backward pass: position of the next request of each chunk.
+			string scratch = tmp_dir.empty() ? name : tmp_dir + "/" + name.substr(name.rfind('/') + 1);
+			scratch += ".next";
+			size_t next_length = n * sizeof(uint64_t);
+			uint64_t *next = (uint64_t *) map_file(scratch, next_length, true, error);
+			if (next == NULL)
+			{
+				cerr << error << endl;
+				return 2;
+			}
+
+			boost::unordered_map<uint64_t, uint64_t> last_seen;
+			for (uint64_t i = n; i-- > 0; )
+			{
+				pair<boost::unordered_map<uint64_t, uint64_t>::iterator, bool> it =
+						last_seen.insert(make_pair(records[i], NEVER));
+				next[i] = it.first->second;
+				it.first->second = i;
+			}
+			last_seen.clear();
+
+			madvise((void *) base, length, MADV_SEQUENTIAL);
+			madvise(next, next_length, MADV_SEQUENTIAL);
+			r = simulate(records, next, n, h->warmup_records, size);
+			munmap(next, next_length);
+		}
+
+		cout << h->node << "\t" << size << "\t" << r.requests << "\t" << r.hits << "\t"
+			 << (r.requests ? (double) r.hits / r.requests : 0) << endl;
+		total_requests += r.requests;
+		total_hits += r.hits;
+		munmap((void *) base, length);
+	}
+
+	if (logs > 1)
+		cout << "all\t-\t" << total_requests << "\t" << total_hits << "\t"
+			 << (total_requests ? (double) total_hits / total_requests : 0) << endl;
+	return 0;
+}
@@ -0,0 +1,426 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * 	Throughput of the CLOCK replacement (RS = "clock_cache") against LRU (RS = "lru_cache") on the
+ * 	tree scenarios, replayed outside the simulator.
+ *
+ * 	Compile it (from the root folder of ccnSim) with:
+ * 		g++ -O2 -Iinclude -o cache_bench scripts/cache_bench.cc
+ *
+ * 	Usage:
+ * 		cache_bench [-M catalog] [-a alpha] [-C cache_size] [-d depth] [-R requests] [-s seed]
+ *
+ * 	The network is a complete binary tree of the given depth (4: networks/tree.ned, 15 nodes;
+ * 	6: networks/tree_6_2.ned, 63 nodes) with the repository at the root and a client at each
+ * 	leaf. Each IRM request (M = 1e6, alpha = 1 by default, as in ED_TTL-omnetpp.ini) is issued
+ * 	by a random leaf and looked up along the path to the root, until a hit; the Data is stored
+ * 	by every cache of the way back (DS = "lce"), as done by base_cache::store.
+ *
+ * 	The two engines replicate lru_cache (malloc'ed lru_pos list + boost::unordered_map) and
+ * 	clock_cache (ring, reference bits and open-addressing index), with the simulation time kept
+ * 	as a double instead of a simtime_t. The request stream is generated beforehand and it is not
+ * 	timed; the output reports the hit ratio of the caches, the one of the leaves, and the time
+ * 	per request and per cache operation (lookup or store).
+ */
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <chrono>
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+
+using namespace std;
+
+typedef uint64_t chunk_t;
+
+// *** lru_cache ***
+struct lru_pos
+{
+	lru_pos *older;
+	lru_pos *newer;
+	chunk_t k;
+	double hit_time;
+	double cost;
+};
+
+class lru_engine
+{
+	public:
+		lru_engine(uint32_t size):cache_size(size),actual_size(0),lru(0),mru(0){;}
+		~lru_engine()
+		{
+			while (lru)
+			{
+				lru_pos *p = lru;
+				lru = lru->newer;
+				free(p);
+			}
+		}
+
+		bool data_lookup(chunk_t elem, double now)
+		{
+			boost::unordered_map<chunk_t,lru_pos *>::iterator it = cache.find(elem);
+			if (it == cache.end())
+				return false;
+
+			lru_pos *pos_elem = it->second;
+			if (pos_elem->older && pos_elem->newer)
+			{
+				pos_elem->newer->older = pos_elem->older;
+				pos_elem->older->newer = pos_elem->newer;
+			}
+			else if (!pos_elem->newer)
+			{
+				pos_elem->hit_time = now;
+				return true;
+			}
+			else
+			{
+				lru = pos_elem->newer;
+				lru->older = 0;
+			}
+			pos_elem->older = mru;
+			pos_elem->newer = 0;
+			mru->newer = pos_elem;
+			mru = pos_elem;
+			pos_elem->hit_time = now;
+			return true;
+		}
+
+		void data_store(chunk_t elem, double now)
+		{
+			if (data_lookup(elem, now))
+				return;
+
+			lru_pos *p = (lru_pos *) malloc(sizeof(lru_pos));
+			p->k = elem;
+			p->hit_time = now;
+			p->newer = 0;
+			p->older = 0;
+
+			if (actual_size == 0)
+			{
+				actual_size++;
+				lru = mru = p;
+				cache[elem] = p;
+				return;
+			}
+
+			p->older = mru;
+			mru->newer = p;
+			mru = p;
+
+			if (actual_size == cache_size)
+			{
+				chunk_t k = lru->k;
+				lru_pos *tmp = lru;
+				lru = tmp->newer;
+				lru->older = 0;
+				free(tmp);
+				cache.erase(k);
+			}
+			else
+				actual_size++;
+			cache[elem] = p;
+		}
+
+	private:
+		uint32_t cache_size;
+		uint32_t actual_size;
+		lru_pos *lru;
+		lru_pos *mru;
+		boost::unordered_map<chunk_t, lru_pos*> cache;
+};
+
+// *** clock_cache ***
+class clock_engine
+{
+	public:
+		clock_engine(uint32_t size):actual_size(0),hand(0)
+		{
+			ring.assign(size, clock_slot());
+			referenced.assign(size, 0);
+			uint64_t buckets = 2;
+			while (buckets < 2 * (uint64_t)size)
+				buckets <<= 1;
+			clock_bucket empty;
+			empty.k = 0;
+			empty.slot = EMPTY_BUCKET;
+			index.assign(buckets, empty);
+			index_mask = buckets - 1;
+		}
+
+		bool data_lookup(chunk_t chunk, double)
+		{
+			uint32_t slot = index_find(chunk);
+			if (slot == EMPTY_BUCKET)
+				return false;
+			referenced[slot] = 1;
+			return true;
+		}
+
+		void data_store(chunk_t chunk, double now)
+		{
+			if (index_find(chunk) != EMPTY_BUCKET)
+				return;
+
+			uint32_t slot;
+			if (actual_size < ring.size())
+				slot = actual_size++;
+			else
+			{
+				while (referenced[hand])
+				{
+					referenced[hand] = 0;
+					ring[hand].t = now;
+					hand = (hand + 1 == ring.size()) ? 0 : hand + 1;
+				}
+				slot = hand;
+				hand = (hand + 1 == ring.size()) ? 0 : hand + 1;
+				index_erase(ring[slot].k);
+			}
+			ring[slot].k = chunk;
+			ring[slot].t = now;
+			referenced[slot] = 0;
+			index_insert(chunk, slot);
+		}
+
+	private:
+		struct clock_slot
+		{
+			chunk_t k;
+			double t;
+		};
+		struct clock_bucket
+		{
+			chunk_t k;
+			uint32_t slot;
+		};
+		static const uint32_t EMPTY_BUCKET = 0xFFFFFFFF;
+
+		uint32_t actual_size;
+		uint32_t hand;
+		vector<clock_slot> ring;
+		vector<uint8_t> referenced;
+		vector<clock_bucket> index;
+		uint64_t index_mask;
+
+		uint64_t bucket_of(chunk_t k) const
+		{
+			uint64_t h = k;
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ULL;
+			h ^= h >> 33;
+			return h & index_mask;
+		}
+
+		uint32_t index_find(chunk_t k) const
+		{
+			for (uint64_t b = bucket_of(k); index[b].slot != EMPTY_BUCKET; b = (b + 1) & index_mask)
+				if (index[b].k == k)
+					return index[b].slot;
+			return EMPTY_BUCKET;
+		}
+
+		void index_insert(chunk_t k, uint32_t slot)
+		{
+			uint64_t b = bucket_of(k);
+			while (index[b].slot != EMPTY_BUCKET)
+				b = (b + 1) & index_mask;
+			index[b].k = k;
+			index[b].slot = slot;
+		}
+
+		void index_erase(chunk_t k)
+		{
+			uint64_t b = bucket_of(k);
+			while (index[b].k != k || index[b].slot == EMPTY_BUCKET)
+				b = (b + 1) & index_mask;
+			uint64_t hole = b;
+			for (uint64_t next = (hole + 1) & index_mask; index[next].slot != EMPTY_BUCKET; next = (next + 1) & index_mask)
+			{
+				uint64_t home = bucket_of(index[next].k);
+				if (((next - home) & index_mask) >= ((next - hole) & index_mask))
+				{
+					index[hole] = index[next];
+					hole = next;
+				}
+			}
+			index[hole].slot = EMPTY_BUCKET;
+		}
+};
+
+// *** Workload ***
+static uint64_t splitmix64(uint64_t &state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+struct request
+{
+	chunk_t chunk;
+	uint32_t leaf;
+};
+
+static void tree_requests(uint64_t catalog, double alpha, uint64_t n, uint32_t leaves, uint64_t seed, vector<request> &out)
+{
+	vector<double> cdf(catalog);
+	double sum = 0;
+	for (uint64_t k = 0; k < catalog; k++)
+		cdf[k] = (sum += pow(k + 1., -alpha));
+	out.resize(n);
+	uint64_t state = seed;
+	for (uint64_t i = 0; i < n; i++)
+	{
+		double u = (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0) * sum;
+		uint64_t id = (lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()) + 1;
+		out[i].chunk = id << 32;		// [name|chunk number 0], as __sid/__schunk.
+		out[i].leaf = splitmix64(state) % leaves;
+	}
+}
+
+struct bench_result
+{
+	double hit;				// Requests served by a cache.
+	double leaf_hit;		// Requests served by the cache of the leaf.
+	double ns_per_request;
+	double ns_per_operation;
+};
+
+template <class E>
+static bench_result run(const vector<request> &req, uint32_t nodes, uint32_t C)
+{
+	vector<E*> caches(nodes);
+	for (uint32_t i = 0; i < nodes; i++)
+		caches[i] = new E(C);
+	uint32_t first_leaf = nodes / 2;
+	uint32_t path[64];
+
+	uint64_t hits = 0, leaf_hits = 0, operations = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < req.size(); i++)
+	{
+		double now = i * 1e-3;
+		int len = 0;
+		bool hit = false;
+		for (uint32_t n = first_leaf + req[i].leaf; ; n = (n - 1) / 2)
+		{
+			path[len++] = n;
+			if ((hit = caches[n]->data_lookup(req[i].chunk, now)) || n == 0)
+				break;		// Hit, or the repository at the root.
+		}
+		operations += len;
+		if (hit)
+		{
+			hits++;
+			leaf_hits += (len == 1);
+			len--;			// The node of the hit does not store the Data again.
+		}
+		for (int k = len - 1; k >= 0; k--)
+			caches[path[k]]->data_store(req[i].chunk, now);
+		operations += len;
+	}
+	double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+	for (uint32_t i = 0; i < nodes; i++)
+		delete caches[i];
+
+	bench_result r;
+	r.hit = hits * 1. / req.size();
+	r.leaf_hit = leaf_hits * 1. / req.size();
+	r.ns_per_request = elapsed / req.size();
+	r.ns_per_operation = elapsed / operations;
+	return r;
+}
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-M catalog] [-a alpha] [-C cache_size] [-d depth] [-R requests] [-s seed]" << endl;
+}
+
+int main(int argc, char **argv)
+{
+	double M = 1e6, alpha = 1, C = 1e4, R = 1e7, seed = 1;
+	int depth = 4;
+
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg += 2)
+	{
+		if (arg + 1 >= argc)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+		if (strcmp(argv[arg], "-M") == 0)
+			M = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-a") == 0)
+			alpha = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-C") == 0)
+			C = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-d") == 0)
+			depth = atoi(argv[arg+1]);
+		else if (strcmp(argv[arg], "-R") == 0)
+			R = atof(argv[arg+1]);
+		else if (strcmp(argv[arg], "-s") == 0)
+			seed = atof(argv[arg+1]);
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (arg < argc || M < 1 || C < 1 || R < 1 || alpha <= 0 || depth < 1 || depth > 20)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	uint32_t nodes = (1u << depth) - 1;
+	vector<request> req;
+	tree_requests((uint64_t) M, alpha, (uint64_t) R, (nodes + 1) / 2, (uint64_t) seed, req);
+
+	bench_result l = run<lru_engine>(req, nodes, (uint32_t) C);
+	bench_result c = run<clock_engine>(req, nodes, (uint32_t) C);
+
+	cout << "M=" << M << " alpha=" << alpha << " C=" << C << " nodes=" << nodes << " R=" << R << endl;
+	cout << "RS\tp_hit\tleaf_p_hit\tns/request\tns/operation" << endl;
+	cout << "lru_cache\t" << l.hit << "\t" << l.leaf_hit << "\t" << l.ns_per_request << "\t" << l.ns_per_operation << endl;
+	cout << "clock_cache\t" << c.hit << "\t" << c.leaf_hit << "\t" << c.ns_per_request << "\t" << c.ns_per_operation << endl;
+	return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * 	Off-line tool for the binary results files written by the results sink (see include/results_sink.h).
+ *
+ * 	Compile it (from the root folder of ccnSim) with:
+ * 		g++ -O2 -Iinclude -o results_merge scripts/results_merge.cc src/statistics/results_sink.cc src/error_handling.cc
+ *
+ * 	Usage:
+ * 		results_merge [-m] out_file run_0 run_1 ... run_N	Average the repetitions cell by cell: each column 'x' of
+ * 															the output contains the mean, while 'x:var' the sample variance.
+ * 		results_merge -s out_file run_0 run_1 ... run_N		Stack the repetitions: rows of the output are the rows of
+ * 															the inputs, and the column 'run' identifies the repetition.
+ * 		results_merge -c in_file [table]					Dump the tables of a file as CSV on the standard output.
+ */
+#include "results_sink.h"
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-m|-s] out_file run_0 [run_1 ... run_N]" << endl;
+	cerr << "       " << prog << " -c in_file [table]" << endl;
+}
+
+static bool load_runs(int argc, char **argv, int first, vector<results_sink> &runs)
+{
+	runs.resize(argc - first);
+	for (int i = first; i < argc; i++)
+		if (!runs[i-first].read(argv[i]))
+		{
+			cerr << "Impossible to read " << argv[i] << endl;
+			return false;
+		}
+	return true;
+}
+
+static void merge_mean(const vector<results_sink> &runs, results_sink &out)
+{
+	for (unsigned int r = 0; r < runs.size(); r++)
+		for (map<string,results_sink::table>::const_iterator it = runs[r].tables.begin(); it != runs[r].tables.end(); ++it)
+		{
+			const results_sink::table &t = it->second;
+			for (unsigned int c = 0; c < t.columns.size(); c++)
+				for (uint32_t row = 0; row < t.rows; row++)
+				{
+					// Welford's online mean and variance, kept inside the output tables.
+					double x = t.values[c][row];
+					if (std::isnan(x))
+						continue;
+					results_sink::table &o = out.tables[it->first];
+					int m_idx = o.column_index(t.columns[c]);
+					int n_idx = o.column_index(t.columns[c] + ":n");
+					double n = 0, mean = 0, m2 = 0;
+					if (m_idx >= 0 && row < o.values[m_idx].size() && !std::isnan(o.values[m_idx][row]))
+					{
+						n = o.values[n_idx][row];
+						mean = o.values[m_idx][row];
+						m2 = o.values[o.column_index(t.columns[c] + ":var")][row];
+					}
+					n++;
+					double delta = x - mean;
+					mean += delta / n;
+					m2 += delta * (x - mean);
+					out.record(it->first, row, t.columns[c], mean);
+					out.record(it->first, row, t.columns[c] + ":var", m2);
+					out.record(it->first, row, t.columns[c] + ":n", n);
+				}
+		}
+
+	// From sum of squares to sample variance.
+	for (map<string,results_sink::table>::iterator it = out.tables.begin(); it != out.tables.end(); ++it)
+	{
+		results_sink::table &o = it->second;
+		for (unsigned int c = 0; c < o.columns.size(); c++)
+		{
+			const string &name = o.columns[c];
+			if (name.size() < 4 || name.compare(name.size()-4, 4, ":var") != 0)
+				continue;
+			int n_idx = o.column_index(name.substr(0, name.size()-4) + ":n");
+			for (uint32_t row = 0; row < o.values[c].size(); row++)
+			{
+				double n = o.values[n_idx][row];
+				if (!std::isnan(n))
+					o.values[c][row] = (n > 1) ? o.values[c][row] / (n - 1) : 0;
+			}
+		}
+	}
+}
+
+static void merge_stack(const vector<results_sink> &runs, results_sink &out)
+{
+	map<string,uint32_t> offset;
+	for (unsigned int r = 0; r < runs.size(); r++)
+		for (map<string,results_sink::table>::const_iterator it = runs[r].tables.begin(); it != runs[r].tables.end(); ++it)
+		{
+			const results_sink::table &t = it->second;
+			uint32_t base = offset[it->first];
+			for (uint32_t row = 0; row < t.rows; row++)
+			{
+				out.record(it->first, base + row, "run", r);
+				out.record(it->first, base + row, "index", row);
+				for (unsigned int c = 0; c < t.columns.size(); c++)
+					out.record(it->first, base + row, t.columns[c], t.values[c][row]);
+			}
+			offset[it->first] = base + t.rows;
+		}
+}
+
+static void dump_csv(const results_sink &in, const char *only_table)
+{
+	for (map<string,results_sink::table>::const_iterator it = in.tables.begin(); it != in.tables.end(); ++it)
+	{
+		if (only_table && it->first != only_table)
+			continue;
+		const results_sink::table &t = it->second;
+		cout << "# " << it->first << endl << "row";
+		for (unsigned int c = 0; c < t.columns.size(); c++)
+			cout << "," << t.columns[c];
+		cout << endl;
+		for (uint32_t row = 0; row < t.rows; row++)
+		{
+			cout << row;
+			for (unsigned int c = 0; c < t.columns.size(); c++)
+			{
+				cout << ",";
+				if (row < t.values[c].size() && !std::isnan(t.values[c][row]))
+					cout << t.values[c][row];
+			}
+			cout << endl;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (strcmp(argv[1], "-c") == 0)
+	{
+		results_sink in;
+		if (!in.read(argv[2]))
+		{
+			cerr << "Impossible to read " << argv[2] << endl;
+			return 2;
+		}
+		dump_csv(in, argc > 3 ? argv[3] : NULL);
+		return 0;
+	}
+
+	bool stack = false;
+	int first = 1;
+	if (strcmp(argv[1], "-s") == 0 || strcmp(argv[1], "-m") == 0)
+	{
+		stack = (argv[1][1] == 's');
+		first = 2;
+	}
+	if (argc - first < 2)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	vector<results_sink> runs;
+	if (!load_runs(argc, argv, first + 1, runs))
+		return 2;
+
+	results_sink out;
+	out.attributes = runs[0].attributes;
+	out.attributes.erase("repetition");
+	out.attributes.erase("runnumber");
+	out.attributes.erase("seedset");
+	stringstream num_runs;
+	num_runs << runs.size();
+	out.attributes["merged_runs"] = num_runs.str();
+
+	if (stack)
+		merge_stack(runs, out);
+	else
+		merge_mean(runs, out);
+
+	if (!out.write_to(argv[first]))
+	{
+		cerr << "Impossible to write " << argv[first] << endl;
+		return 2;
+	}
+	return 0;
+}
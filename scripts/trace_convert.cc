@@ -0,0 +1,262 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * 	Converter from text/CSV request logs to the binary trace replayed by client_Trace
+ * 	(see include/trace_file.h for the format).
+ *
+ * 	Compile it (from the root folder of ccnSim) with:
+ * 		g++ -O2 -Iinclude -o trace_convert scripts/trace_convert.cc
+ *
+ * 	Usage:
+ * 		trace_convert [-n num_clients] [-b chunk_bytes] in_log out_trace
+ *
+ * 	Each line of the log is a request "timestamp,client,content,size" (fields can be separated by commas,
+ * 	semicolons, tabs or spaces). Client and content identifiers can be arbitrary strings. Empty lines,
+ * 	lines starting with '#' and a header line (non numeric timestamp) are skipped. The size of a
+ * 	content is the largest one requested inside the log (a missing size counts as one chunk).
+ * 		- num_clients: clients of the log are folded into (at most) num_clients simulated clients
+ * 		  (default: one simulated client per client of the log);
+ * 		- chunk_bytes: the size column is expressed in bytes, and it is converted into chunks of
+ * 		  chunk_bytes bytes (default: the size is already expressed in chunks).
+ */
+#include "trace_file.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <boost/unordered_map.hpp>
+
+using namespace std;
+
+static void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-n num_clients] [-b chunk_bytes] in_log out_trace" << endl;
+}
+
+// Split a line into (at most) 4 fields, without allocating.
+static int split(char *line, char **fields)
+{
+	int n = 0;
+	char *p = line;
+	while (*p && n < 4)
+	{
+		while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';')
+			p++;
+		if (!*p || *p == '\n' || *p == '\r')
+			break;
+		fields[n++] = p;
+		while (*p && *p != ' ' && *p != '\t' && *p != ',' && *p != ';' && *p != '\n' && *p != '\r')
+			p++;
+		if (*p)
+			*p++ = '\0';
+	}
+	return n;
+}
+
+static bool by_client_and_time(const trace_record &a, const trace_record &b)
+{
+	if (a.client != b.client)
+		return a.client < b.client;
+	return a.time < b.time;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t max_clients = 0;
+	double chunk_bytes = 0;
+	int arg = 1;
+
+	for (; arg < argc && argv[arg][0] == '-'; arg += 2)
+	{
+		if (arg + 1 >= argc)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+		if (strcmp(argv[arg], "-n") == 0)
+			max_clients = atoi(argv[arg+1]);
+		else if (strcmp(argv[arg], "-b") == 0)
+			chunk_bytes = atof(argv[arg+1]);
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (argc - arg != 2)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	ifstream in(argv[arg]);
+	if (!in)
+	{
+		cerr << "Impossible to open " << argv[arg] << endl;
+		return 2;
+	}
+
+	// First pass: parse the log, and give dense IDs to clients and contents (in order of appearance).
+	boost::unordered_map<string,uint32_t> client_ids;
+	boost::unordered_map<string,uint32_t> content_ids;
+	vector<uint64_t> requests;		// Number of requests of each content (by appearance ID).
+	vector<uint32_t> max_size;		// Largest size requested for each content.
+	vector<trace_record> records;
+	double start = 0;
+	string line;
+	unsigned long line_num = 0, skipped = 0;
+
+	while (getline(in, line))
+	{
+		line_num++;
+		if (line.empty() || line[0] == '#')
+			continue;
+		char *fields[4];
+		int n = split(&line[0], fields);
+		char *end;
+		double t = (n > 0) ? strtod(fields[0], &end) : 0;
+		if (n < 3 || end == fields[0])
+		{
+			skipped++;		// Header or malformed line.
+			continue;
+		}
+
+		trace_record r;
+		r.time = t;
+
+		boost::unordered_map<string,uint32_t>::iterator it = client_ids.find(fields[1]);
+		if (it == client_ids.end())
+			it = client_ids.insert(make_pair(string(fields[1]), (uint32_t) client_ids.size())).first;
+		r.client = it->second;
+
+		it = content_ids.find(fields[2]);
+		if (it == content_ids.end())
+		{
+			it = content_ids.insert(make_pair(string(fields[2]), (uint32_t) content_ids.size())).first;
+			requests.push_back(0);
+			max_size.push_back(1);
+		}
+		r.content = it->second;
+
+		double size = (n > 3) ? atof(fields[3]) : 1;
+		if (chunk_bytes > 0)
+			size = ceil(size / chunk_bytes);
+		uint32_t chunks = size < 1 ? 1 : (size > 0xFFFF ? 0xFFFF : (uint32_t) size);	// The catalog stores sizes on 16 bits.
+
+		requests[r.content]++;
+		max_size[r.content] = max(max_size[r.content], chunks);
+		if (records.empty() || t < start)
+			start = t;
+		records.push_back(r);
+	}
+
+	if (records.empty())
+	{
+		cerr << "No valid request inside " << argv[arg] << endl;
+		return 2;
+	}
+
+	// Rank contents by decreasing popularity (ID 1 is the most requested one).
+	vector<uint32_t> order(requests.size());
+	for (uint32_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	stable_sort(order.begin(), order.end(), [&requests](uint32_t a, uint32_t b) {return requests[a] > requests[b];});
+	vector<uint32_t> rank(order.size());
+	vector<uint16_t> sizes(order.size());
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		rank[order[i]] = i + 1;
+		sizes[i] = max_size[order[i]];
+	}
+
+	uint32_t num_clients = client_ids.size();
+	if (max_clients > 0 && num_clients > max_clients)
+		num_clients = max_clients;
+
+	double duration = 0;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		records[i].time -= start;
+		records[i].content = rank[records[i].content];
+		records[i].client %= num_clients;
+		duration = max(duration, records[i].time);
+	}
+	stable_sort(records.begin(), records.end(), by_client_and_time);
+
+	vector<uint64_t> index(num_clients + 1, 0);
+	for (size_t i = 0; i < records.size(); i++)
+		index[records[i].client + 1]++;
+	for (uint32_t k = 0; k < num_clients; k++)
+		index[k+1] += index[k];
+
+	// Write the binary trace.
+	trace_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+	h.version = TRACE_VERSION;
+	h.num_records = records.size();
+	h.num_contents = sizes.size();
+	h.num_clients = num_clients;
+	h.record_size = sizeof(trace_record);
+	h.sizes_offset = sizeof(trace_header);
+	h.index_offset = (h.sizes_offset + sizes.size() * sizeof(uint16_t) + 7) & ~((uint64_t) 7);
+	h.records_offset = h.index_offset + index.size() * sizeof(uint64_t);
+	h.duration = duration;
+
+	ofstream out(argv[arg+1], ios::out | ios::binary | ios::trunc);
+	if (!out)
+	{
+		cerr << "Impossible to write " << argv[arg+1] << endl;
+		return 2;
+	}
+	static const char padding[8] = {0};
+	out.write((const char *) &h, sizeof(h));
+	out.write((const char *) &sizes[0], sizes.size() * sizeof(uint16_t));
+	out.write(padding, h.index_offset - h.sizes_offset - sizes.size() * sizeof(uint16_t));
+	out.write((const char *) &index[0], index.size() * sizeof(uint64_t));
+	out.write((const char *) &records[0], records.size() * sizeof(trace_record));
+	if (!out)
+	{
+		cerr << "Error while writing " << argv[arg+1] << endl;
+		return 2;
+	}
+
+	cout << "Requests: " << records.size() << " (skipped lines: " << skipped << " out of " << line_num << ")" << endl;
+	cout << "Contents: " << sizes.size() << endl;
+	cout << "Clients: " << num_clients << " (clients inside the log: " << client_ids.size() << ")" << endl;
+	cout << "Duration: " << duration << " s" << endl;
+	return 0;
+}
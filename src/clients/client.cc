@@ -39,9 +39,11 @@
 #include "client.h"
 
 #include "error_handling.h"
+#include "results_sink.h"
 #include <random>
 
 Register_Class (client);
+int client::last_nonce = 0;
 
 
 void client::initialize()
@@ -50,6 +52,14 @@ void client::initialize()
 
 	RTT = par("RTT");
 
+	segment_train = par("segment_train");
+	if (segment_train < 1 || segment_train > MAX_TRAIN)
+	{
+		std::stringstream ermsg;
+		ermsg<<"segment_train="<<segment_train<<" is not valid: it must be in [1,"<<MAX_TRAIN<<"]";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
 	//Allocating file statistics
 	//**mt** DISABLED
 	//client_stats = new client_stat_entry[__file_bulk+1];
@@ -75,19 +85,12 @@ void client::finish()
     //	Output average local statistics.
     if (active)
     {
-    	char name [30];
-		sprintf ( name, "hdistance[%d]", getNodeIndex());
-		recordScalar (name, avg_distance);
-
-		sprintf ( name, "downloads[%d]",getNodeIndex());
-		recordScalar (name, tot_downloads );
-
-		sprintf ( name, "avg_time[%d]",getNodeIndex());
-		recordScalar (name, avg_time);
+		record_result(this, "client", getNodeIndex(), "hdistance", avg_distance);
+		record_result(this, "client", getNodeIndex(), "downloads", tot_downloads);
+		record_result(this, "client", getNodeIndex(), "avg_time", SIMTIME_DBL(avg_time));
 
 		#ifdef SEVERE_DEBUG
-		sprintf ( name, "interests_sent[%d]",getNodeIndex());
-		recordScalar (name, interests_sent );
+		record_result(this, "client", getNodeIndex(), "interests_sent", interests_sent);
 
 		if (interests_sent != tot_downloads)
 		{
@@ -101,6 +104,7 @@ void client::finish()
 		#endif
 
 		//Output per file statistics
+		//char name [30];
 		//sprintf ( name, "hdistance[%d]", getNodeIndex());
 		//cOutVector distance_vector(name);
 
@@ -143,7 +147,7 @@ void client::handle_timers(cMessage *timer)
 }
 
 
-void client::resend_interest(name_t name,cnumber_t number, int toward)
+void client::resend_interest(name_t name,cnumber_t number, int toward, int range)
 {
     chunk_t chunk = 0;
     ccn_interest* interest = new ccn_interest("interest",CCN_I);
@@ -151,8 +155,10 @@ void client::resend_interest(name_t name,cnumber_t number, int toward)
     __schunk(chunk, number);
 
     interest->setChunk(chunk);
+    interest->setRange(range > 0 ? range : train_length(name, number));
     interest->setHops(-1);
     interest->setTarget(toward);
+    interest->setNonce(++last_nonce);
     interest->setNfound(true);
     send(interest, "client_port$o");
 
@@ -174,8 +180,10 @@ void client::send_interest(name_t name,cnumber_t number, int toward)
     __schunk(chunk, number);
 
     interest->setChunk(chunk);
+    interest->setRange(train_length(name, number));
     interest->setHops(-1);
     interest->setTarget(toward);
+    interest->setNonce(++last_nonce);
 
 	#ifdef SEVERE_DEBUG
 	interest->setSerialNumber(interests_sent);
@@ -188,11 +196,22 @@ void client::send_interest(name_t name,cnumber_t number, int toward)
 
 
 
+/*
+ * 	Number of chunks requested by the Interest for chunk 'number' of object 'name', i.e.,
+ * 	'segment_train' chunks, truncated at the end of the object.
+ */
+int client::train_length(name_t name, cnumber_t number)
+{
+	int left = __size(name) - number;
+	return left < segment_train ? left : segment_train;
+}
+
 void client::handle_incoming_chunk (ccn_data *data_message)
 {
     cnumber_t chunk_num = data_message -> get_chunk_num();
     name_t name = data_message -> get_name();
     filesize_t size = data_message -> get_size();
+    int range = data_message -> getRange();		// Number of chunks carried (segment train).
 
 	#ifdef SEVERE_DEBUG
 		if ( !is_waiting_for(name) )
@@ -213,9 +232,9 @@ void client::handle_incoming_chunk (ccn_data *data_message)
 	#endif
 
     //----------Statistics-----------------
-    // Update average statistics.
-    avg_distance = (tot_chunks*avg_distance+data_message->getHops())/(tot_chunks+1);
-    tot_downloads+=1./size;
+    // Average statistics are updated below, only with the chunks awaited by a download (duplicate
+    // or unsolicited Data are not counted). Every chunk of a segment train counts as a separate chunk.
+    unsigned int matched = 0;
 
     // Statistics for each file. Only those regarding the specified part of the catalog
     // (i.e., the most '__file_bulk' popular contents are gathered.
@@ -239,9 +258,15 @@ void client::handle_incoming_chunk (ccn_data *data_message)
 
     while (it != ii.second)
 	{
-        if ( it->second.chunk == chunk_num )
+        // The download is waiting for a chunk inside the received train.
+        if ( it->second.chunk >= chunk_num && it->second.chunk < chunk_num + range )
 		{
-            it->second.chunk++;
+            unsigned int awaited = chunk_num + range - it->second.chunk;
+            avg_distance = ((tot_chunks+matched)*avg_distance+awaited*data_message->getHops())/(tot_chunks+matched+awaited);
+            tot_downloads+=(double)awaited/size;
+            matched += awaited;
+
+            it->second.chunk = chunk_num + range;
             if (it->second.chunk< __size(name) )
 			{ 
 		    	it->second.last = simTime();
@@ -267,7 +292,7 @@ void client::handle_incoming_chunk (ccn_data *data_message)
         }
         ++it;
     }
-    tot_chunks++;
+    tot_chunks+=matched;
 }
 
 void client::clear_stat(){
@@ -51,6 +51,7 @@ void client_IRM::initialize()
 	if (find(content_distribution::clients, content_distribution::clients + num_clients ,getNodeIndex()) != content_distribution::clients + num_clients)
 	{
 		active = true;
+		rng = ccn_rng(this, 0);
 		lambda = getAncestorPar("lambda");
 		check_time	= getAncestorPar("check_time");
 
@@ -82,12 +83,12 @@ void client_IRM::initialize()
 			{
 				// Schedule a ModelGraft request (i.e., arrival_ttl) at lambda/down rate
 				arrival_ttl = new cMessage("arrival_ttl", ARRIVAL_TTL);
-				scheduleAt( simTime() + uniform(0,(double)(1./(double)(lambda/down))), arrival_ttl);
+				scheduleAt( simTime() + rng.uniform(0,(double)(1./(double)(lambda/down))), arrival_ttl);
 			}
 			else if(down == 1)		// ED-sim scenario: schedule one request with the overall lambda mean.
 			{
 				arrival = new cMessage("arrival", ARRIVAL);
-				scheduleAt( simTime() + uniform(0,1./lambda), arrival);
+				scheduleAt( simTime() + rng.uniform(0,1./lambda), arrival);
 			}
 			else
 			{
@@ -116,11 +117,11 @@ void client_IRM::handleMessage(cMessage *in)
 		{
 		case ARRIVAL:
 			request_file(newCard+1);   // 'newCard+1' is needed to discern between ED and ModelGraft.
-			scheduleAt( simTime() + exponential(1./lambda), arrival );
+			scheduleAt( simTime() + rng.exponential(1./lambda), arrival );
 			break;
 		case ARRIVAL_TTL:
 			// Extract a content from the original catalog (i.e., M cardinality) through the inversion rejection sampling
-			origContent = content_distribution::zipf[0]->sample();
+			origContent = content_distribution::zipf[0]->sample(&rng);
 
 			// Compute the correspondent meta-content to be requested (i.e., newCard cardinality)
 			metaContent = floor(origContent/down) + 1;
@@ -128,7 +129,7 @@ void client_IRM::handleMessage(cMessage *in)
 			if(metaContent > 0 && metaContent <= newCard)
 			{
 				request_file(metaContent);
-				scheduleAt( simTime() + exponential(1./(lambda/down)), arrival_ttl);  // Schedule the next request
+				scheduleAt( simTime() + rng.exponential(1./(lambda/down)), arrival_ttl);  // Schedule the next request
 			}
 			else
 			{
@@ -192,7 +193,7 @@ void client_IRM::request_file(unsigned long nameC)
 	name_t name;
 
 	if(nameC == newCard+1)  // ED-sim
-		name = content_distribution::zipf[0]->sample();	// Extract a content from the original catalog (rejection-inversion sampling)
+		name = content_distribution::zipf[0]->sample(&rng);	// Extract a content from the original catalog (rejection-inversion sampling)
 	else					// ModelGraft (TTL_based)
 		name = (name_t) nameC;
 
@@ -53,6 +53,8 @@ void client_ShotNoise::initialize(int stage)
 		active = false;
 		if (find(content_distribution::clients, content_distribution::clients + num_clients ,getNodeIndex()) != content_distribution::clients + num_clients)
 		{
+			rng = ccn_rng(this, 0);
+
 			// Initialize the pointer to ShotNoiseContentDistribution in order to take useful info,
 			// like number of classes with the respective request rates.
 			cModule* pSubModule = getParentModule()->getSubmodule("content_distribution");
@@ -74,7 +76,7 @@ void client_ShotNoise::initialize(int stage)
 						// The identifier of each msg will correspond to the class number.
 						cMessage* tempArrival = new cMessage("tempArrival", (short)(i+1));
 						arrivals.push_back(tempArrival);
-						scheduleAt( simTime() + exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
+						scheduleAt( simTime() + rng.exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
 
 						// Check if the class will be modeled as ON-OFF.
 						if (snPointer->classInfo->operator [](i).ton > snPointer->steadySimTime)
@@ -134,7 +136,7 @@ void client_ShotNoise::handleMessage(cMessage *in)
     				request_file(i+1);  	// Request contents from the 'msgID'-th popularity class.
 
     				// Re-schedule a request according to the lambda of the 'msgID' class.
-    				scheduleAt( simTime() + exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
+    				scheduleAt( simTime() + rng.exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
     				check = true;
     				scheduledReq[i]++;
     			}
@@ -193,7 +195,7 @@ void client_ShotNoise::request_file(int cNum)
 {
 	// Extract a 'local' content ID from the range associated to class 'cNum'.
 	//name_t nameLocal = snPointer->zipfClasses.operator [](cNum-1)->value(dblrand());
-	name_t nameLocal = snPointer->zipfClasses.operator [](cNum-1)->sample();
+	name_t nameLocal = snPointer->zipfClasses.operator [](cNum-1)->sample(&rng);
 
 	// Obtaining the 'global' content ID by adding the lower bound ID of class 'cNum'.
 	name_t nameGlobal = snPointer->classInfo->operator [](cNum-1).mostPopular - 1  + nameLocal;
@@ -246,8 +248,9 @@ void client_ShotNoise::request_file(int cNum)
 }
 
 /*
- * 		Validate the request for the extracted content. Both the 'State' (i.e., ON/OFF) and the
- * 		'Transition Time' of the specified content are checked end eventually updated.
+ * 		Validate the request for the extracted content, i.e., check that the specified content is
+ * 		within an ON period. The ON/OFF process of each content is derived by the content distribution,
+ * 		so the validation does not modify any state.
  *
  * 		Parameters:
  * 		- cNum: class number;
@@ -255,60 +258,5 @@ void client_ShotNoise::request_file(int cNum)
  */
 bool client_ShotNoise::validateRequest(int cNum, name_t ID)
 {
-	bool sendOk = true;
-	simtime_t contentTime = snPointer->get_state_time(ID-1);
-
-	if (snPointer->check_state_flag(ID-1))  	// The content was ON.
-	{
-		if (simTime() <= contentTime)  			// The content is still ON.
-		{
-			// Do nothing. The content was ON and it is still ON; as a consequence, 'sendOK' remains true.
-		}
-		else	// Sim_time > ON_time associated to the content, which, as a consequence,
-			    // can be either ON or OFF at the current moment. Therefore, we need to update
-				// the ON/OFF process (state and transition time) associated to the content.
-		{
-			while (contentTime < simTime())
-			{
-				// We add first the OFF time because the content was in a ON state.
-				contentTime += snPointer->classInfo->operator [](cNum-1).toff;
-				snPointer->unset_state_flag(ID-1);
-				sendOk = false;
-				if (contentTime < simTime())	// We need to extract another ON time.
-				{
-					contentTime += (simtime_t)exponential(snPointer->classInfo->operator [](cNum-1).ton);
-					snPointer->set_state_flag(ID-1);
-					sendOk = true;
-				}
-			}
-			snPointer->set_state_time(ID-1, contentTime);		// Update the transition time of the content.
-		}
-	}
-	else		// The content was OFF.
-	{
-		if (simTime() <= contentTime)	// The content is still OFF.
-		{
-			sendOk = false;		// Do not generate the request.
-		}
-		else	// Sim_time > OFF_time associated to the content, which, as a consequence,
-		    	// can be either ON or OFF at the current moment. Therefore, we need to update
-				// the ON/OFF process (state and transition time) associated to the content.
-		{
-			while (contentTime < simTime())
-			{
-				// We add first the ON time because the content was in a OFF state.
-				contentTime += (simtime_t)exponential(snPointer->classInfo->operator [](cNum-1).ton);
-				snPointer->set_state_flag(ID-1);
-				sendOk = true;
-				if(contentTime < simTime())		// We need to extract another OFF time.
-				{
-					contentTime += snPointer->classInfo->operator [](cNum-1).toff;
-					snPointer->unset_state_flag(ID-1);
-					sendOk = false;
-				}
-			}
-			snPointer->set_state_time(ID-1, contentTime);			// Update the transition time of the content.
-		}
-	}
-	return sendOk;
+	return snPointer->check_state_flag(ID-1);
 }
@@ -0,0 +1,206 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "content_distribution.h"
+
+#include "statistics.h"
+
+#include "ccn_interest.h"
+#include "ccn_data.h"
+
+#include "ccnsim.h"
+#include "client_Trace.h"
+
+#include "error_handling.h"
+
+Register_Class (client_Trace);
+
+TraceContentDistribution* client_Trace::trPointer;
+
+void client_Trace::initialize(int stage)
+{
+	if(stage == 1)		// Multi-stage initialization (the trace is mapped by TraceContentDistribution).
+	{
+		int num_clients = getAncestorPar("num_clients");
+		int* pos = find(content_distribution::clients, content_distribution::clients + num_clients ,getNodeIndex());
+		active = false;
+		arrival = NULL;
+		if (pos != content_distribution::clients + num_clients)
+		{
+			cModule* pSubModule = getParentModule()->getSubmodule("content_distribution");
+			trPointer = dynamic_cast<TraceContentDistribution*>(pSubModule);
+			if (!trPointer)
+			{
+				// ERROR MSG: client_Trace is strictly associated to the TraceContentDistribution.
+				std::stringstream ermsg;
+				ermsg<<"A 'Trace' client type requires to instantiate a 'Trace' content distribution"<<
+						" type. Please check.";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+
+			active = true;
+			lambda = getAncestorPar("lambda");		// Unused (requests are those of the trace).
+			check_time	= getAncestorPar("check_time");
+			time_scale = par("time_scale");
+			window = par("prefetch_window");
+
+			timer = new cMessage("timer", TIMER);
+			scheduleAt( simTime() + check_time, timer );
+
+			// Requests of the trace client with the same position of this client.
+			uint32_t section = pos - content_distribution::clients;
+			if (section < trPointer->trace.get_num_clients())
+			{
+				cursor = trPointer->trace.section_begin(section);
+				end = trPointer->trace.section_end(section);
+			}
+			else
+			{
+				cout << "Client " << getNodeIndex() << ": no requests inside the trace\n";
+				cursor = end = trPointer->trace.records_end();
+			}
+
+			window_begin = cursor;
+			window_mark = (end - cursor > window) ? cursor + window : end;
+			trPointer->trace.prefetch(cursor, (end - cursor > 2*window) ? cursor + 2*window : end);
+
+			if (cursor != end)
+			{
+				arrival = new cMessage("arrival", ARRIVAL);
+				scheduleAt( simTime() + cursor->time * time_scale, arrival);
+			}
+			client::initialize();
+		}
+	}
+}
+
+int client_Trace::numInitStages() const
+{
+	return 2;
+}
+
+void client_Trace::finish()
+{
+	client::finish();
+}
+
+void client_Trace::handleMessage(cMessage *in)
+{
+    if (in->isSelfMessage())	// A self-generated message can be either an 'ARRIVAL' or a 'TIMER'.
+    {
+		switch(in->getKind())
+		{
+		case ARRIVAL:
+			// Replay all the requests up to the current time (timestamps can be equal).
+			do {
+				request_file(cursor->content);
+				++cursor;
+			} while (cursor != end && cursor->time * time_scale <= SIMTIME_DBL(simTime()) );
+
+			if (cursor >= window_mark)
+				slide_window();
+
+			if (cursor != end)
+				scheduleAt( cursor->time * time_scale, arrival );
+			else
+				cout << "Client " << getNodeIndex() << ": trace ended at time " << simTime() << "\n";
+			break;
+		case TIMER:
+			handle_timers(in);
+			scheduleAt( simTime() + check_time, timer );
+			break;
+		default:
+			std::stringstream ermsg_a;
+			ermsg_a<<"ERROR - Client Trace: received wrong self message identifier. Please check";
+			severe_error(__FILE__,__LINE__,ermsg_a.str().c_str() );
+			break;
+		}
+		return;
+    }
+
+    switch (in->getKind())		// In case of an external message, it can only be a DATA packet.
+ 	{
+ 		case CCN_D:
+ 		{
+ 			ccn_data *data_message = (ccn_data *) in;
+ 			handle_incoming_chunk (data_message);
+ 			delete  data_message;
+ 			break;
+ 		}
+
+ 		#ifdef SEVERE_DEBUG
+ 		default:
+ 			std::stringstream ermsg;
+ 			ermsg<<"Clients can only receive DATA, while this is a message"<<
+ 				" of TYPE "<<in->getKind();
+ 			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+ 		#endif
+    }
+}
+
+/*
+ * 	Slide the prefetch window: records already replayed are released, and the
+ * 	ones of the window after the next one are prefetched.
+ */
+void client_Trace::slide_window()
+{
+	trPointer->trace.release(window_begin, cursor);
+	window_begin = cursor;
+
+	const trace_record *next = (end - cursor > window) ? cursor + window : end;
+	trPointer->trace.prefetch(next, (end - next > window) ? next + window : end);
+	window_mark = next;
+}
+
+/*
+ *		Send the Interest packet for the first chunk of a content requested inside the trace.
+ *
+ *		Parameters:
+ *		- name: content ID.
+ */
+void client_Trace::request_file(name_t name)
+{
+	#ifdef SEVERE_DEBUG
+	if (name == 0 || name > trPointer->trace.get_num_contents()){
+		std::stringstream ermsg;
+		ermsg<<"Client attached to node "<< getNodeIndex() <<" is replaying a request for content "
+			<<name<<", which is not part of the catalog";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	#endif
+
+	struct download new_download = download (0,simTime() );
+	#ifdef SEVERE_DEBUG
+	new_download.serial_number = interests_sent;
+	#endif
+
+	current_downloads.insert(pair<name_t, download >(name, new_download ) );
+	send_interest(name, 0 ,-1);
+}
@@ -39,10 +39,12 @@
 #include "client_Window.h"
 
 #include "error_handling.h"
-#include <random>
+#include "results_sink.h"
 
 Register_Class (client_Window);
 
+static const double MAX_RTO = 60;		// Upper bound of the exponential backoff [s].
+
 
 void client_Window::initialize()
 {
@@ -51,47 +53,58 @@ void client_Window::initialize()
 	if (find(content_distribution::clients, content_distribution::clients + num_clients ,getNodeIndex()) != content_distribution::clients + num_clients)
 	{
 		active = true;
-		//cout << "Initializing IRM client...\n";
+		rng = ccn_rng(this, 0);
 		lambda = getAncestorPar("lambda");
 		check_time	= getAncestorPar("check_time");
-		arrival = new cMessage("arrival", ARRIVAL );
-		//scheduleAt( simTime() + exponential(1./lambda), arrival);
-		scheduleAt( simTime() + 1./lambda, arrival);
-		//scheduleAt( simTime() + uniform(0,1./lambda), arrival);
-		// ** NB ** Disable check for retransmission.
-		timer = new cMessage("timer", TIMER);
-		scheduleAt( simTime() + check_time, timer );
+
+		string cc_name = par("congestion_control").stdstringValue();
+		if (cc_name == "aimd")
+			cc = CC_AIMD;
+		else if (cc_name == "delay")
+			cc = CC_DELAY;
+		else
+		{
+			std::stringstream ermsg;
+			ermsg<<"congestion_control="<<cc_name<<" is not valid: it must be aimd or delay";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
 
 		defWinSize = par("defWinSize");
 		maxWinSize = par("maxWinSize");
-		currWinSize = defWinSize;
+		md_factor = par("md_factor");
+		delay_alpha = par("delay_alpha");
+		delay_beta = par("delay_beta");
+		min_rto = par("min_rto");
+		init_rto = par("RTT");
+		if (defWinSize < 1 || maxWinSize < defWinSize || md_factor <= 0 || md_factor >= 1 || delay_alpha > delay_beta)
+		{
+			std::stringstream ermsg;
+			ermsg<<"Window parameters are not valid: 1 <= defWinSize <= maxWinSize, 0 < md_factor < 1 and"
+				<<" delay_alpha <= delay_beta are required";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
 
-		// Being an open-loop flow control, we set a deterministic timer in order to reset the size of the window,
-		// depending on the maximum size achievable for the window itself.
-		winTout = 0.0;
-		for(int i=1; i<=maxWinSize; i++)
-			winTout += i*(1./lambda);
-		winTimeout = new cMessage("winTimeout", WinTO);
-		scheduleAt( simTime() + winTout - 1.0/lambda, winTimeout);
+		timeouts = 0;
+		rtt_sum = 0;
+		rtt_samples = 0;
 
-		client::initialize();
+		arrival = new cMessage("arrival", ARRIVAL );
+		scheduleAt( simTime() + rng.exponential(1./lambda), arrival);
+		timer = new cMessage("timer", TIMER);
+		scheduleAt( simTime() + check_time, timer );
 
-		/*
-		 * Possible option to set a separate timer for each content that will be simulated using the TTL-based caches.
-		 * Their original lambas will be used..in this case it won't be necessary anymore to rely on
-		 * the zipf vector to establish which content to take
-		 */
-		/*for(int x=0; x<numOfApps; x++)
-		{
-		cMessage *timer = new cMessage("timerMsg-unique-string",  x);
-		scheduleAt(simTime()+someValue, timer);
-		}*/
+		client::initialize();
 	}
 }
 
 void client_Window::finish()
 {
 	client::finish();
+	if (active)
+	{
+		record_result(this, "client", getNodeIndex(), "cc_timeouts", timeouts);
+		record_result(this, "client", getNodeIndex(), "cc_rtt", rtt_samples ? rtt_sum / rtt_samples : 0);
+	}
 }
 
 void client_Window::handleMessage(cMessage *in)
@@ -101,32 +114,16 @@ void client_Window::handleMessage(cMessage *in)
 		switch(in->getKind())
 		{
 		case ARRIVAL:
-			request_file_window(0);   // Default class num is '0' for client IRM.
-
-			// ** NB ** Requests will be scheduled at the reception of Data packets, and only when inFlightPkts = 0.
-
-			//scheduleAt( simTime() + exponential(1./lambda), arrival );
-			//scheduleAt( simTime() + exponential(1./lambda), arrival );
-			//scheduleAt( simTime() + 1./lambda, arrival);
-			//scheduleAt( simTime() + uniform(0,1./lambda), arrival);
+			request_file(0);   // Default class num is '0' for client IRM.
+			scheduleAt( simTime() + rng.exponential(1./lambda), arrival );
 			break;
 		case TIMER:
 			handle_timers(in);
 			scheduleAt( simTime() + check_time, timer );
 			break;
-		case WinTO:
-			// Reset the window size to its default value
-			if (getNodeIndex() == 7)
-			{
-				cout << SIMTIME_DBL(simTime()) << "\t *** Window TO - Reset to Default Value ***" << endl;
-			}
-
-			currWinSize = defWinSize;
-			scheduleAt( simTime() + winTout - 1.0, winTimeout);
-			break;
 		default:
 			 std::stringstream ermsg;
-			 ermsg<<"ERROR - Client IRM: received wrong self message identifier. Please check";
+			 ermsg<<"ERROR - Client Window: received wrong self message identifier. Please check";
 			 severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 		 }
 		return;
@@ -148,25 +145,6 @@ void client_Window::handleMessage(cMessage *in)
  			ccn_data *data_message = (ccn_data *) in;
  			handle_incoming_chunk (data_message);
  			delete  data_message;
-
-
- 			// Decrease the inFlightPkts and check if an increment of the window size (along with a new batch request) is allowed.
- 			/*if (getNodeIndex() == 7)
- 			{
- 				cout << SIMTIME_DBL(simTime()) << "\t # In-Flight Packets = " << inFlightPkts << endl;
- 			}*/
- 			inFlightPkts--;
- 			if(inFlightPkts == 0) // All the Data packets of the previous Window have been received.
- 			{
- 				scheduleAt( simTime() + currWinSize/lambda - (0.1/lambda)*currWinSize, arrival);
- 				if(currWinSize < maxWinSize)
- 					currWinSize++;
- 				/*if (getNodeIndex() == 7)
- 				{
- 					cout << SIMTIME_DBL(simTime()) << "\t Scheduling Requests for WIN SIZE = " << currWinSize << endl;
- 				}*/
- 			}
-
  			break;
  		}
 
@@ -180,102 +158,222 @@ void client_Window::handleMessage(cMessage *in)
     }
 }
 
-void client_Window::request_file_window(unsigned long cNum)
+/*
+ *		Start the download of an object extracted according to the IRM. The download is also
+ *		inserted in the download tracker (current_downloads), where 'last' is the time of its last
+ *		progress.
+ *
+ *		Parameters:
+ *		- class number ('0' for IRM clients; not used, there is a single catalog).
+ */
+void client_Window::request_file(unsigned long)
 {
-	if (getNodeIndex() == 7)
+	name_t name = content_distribution::zipf[0]->sample(&rng);  // With Rejection-inversion sampling
+
+	window_flow flow;
+	flow.start = simTime();
+	flow.next_chunk = 0;
+	flow.received = 0;
+	flow.cwnd = defWinSize;
+	flow.ssthresh = maxWinSize;
+	flow.srtt = flow.rttvar = 0;
+	flow.rto = init_rto;
+	flow.min_rtt = 0;
+
+	current_downloads.insert(pair<name_t, download >(name, download(0, simTime()) ) );
+	multimap<name_t, window_flow>::iterator it = flows.insert(pair<name_t, window_flow>(name, flow));
+	fill_window(name, it->second);
+}
+
+/*
+ * 	Send the Interests allowed by the window of a download (pipelining).
+ */
+void client_Window::fill_window(name_t name, window_flow &flow)
+{
+	while (flow.in_flight.size() < (unsigned) flow.cwnd && flow.next_chunk < __size(name))
 	{
-		cout << SIMTIME_DBL(simTime()) << "\t Requests with WIN SIZE = " << currWinSize << endl;
+		pending_interest p;
+		p.sent = simTime();
+		p.range = train_length(name, flow.next_chunk);
+		p.missing = train_mask(0, p.range);
+		p.retransmitted = false;
+		flow.in_flight[flow.next_chunk] = p;
+
+		send_interest(name, flow.next_chunk, -1);
+		flow.next_chunk += p.range;
 	}
+}
 
-	vector<name_t> reqContents;
-	reqContents.push_back(0);
-	bool found = true;
-
-	for (int i=1; i<=currWinSize; i++)
+/*
+ * 	RTT estimation (RFC 6298) and base RTT of a download.
+ */
+void client_Window::rtt_sample(window_flow &flow, double rtt)
+{
+	if (flow.srtt == 0)
 	{
-		name_t name;
-		while(found)
-		{
-			//name = content_distribution::zipf.value(dblrand());
-			name = content_distribution::zipf[0]->sample();  // With Rejection-inversion sampling
-			if(find(reqContents.begin(), reqContents.end(), name) == reqContents.end())
-				found = false;
-		}
-
-		found = true;
-
-		reqContents.push_back(name);
-
-		// ****  NB - COMMENT with Rejection-Inversion sampling
-		/*// Check if the catalog aggregation is active. In this case, request for less popular contents
-		// after a specified percentile are generated by randomly selecting an ID within that range.
-		if (content_distribution::zipf.get_perc_aggr() < 1.0)
-		{
-			if (name == content_distribution::zipf.get_ID_aggr()+1) // In case of catalog aggregation, the vector
-																	// containing the Zipf cdf is truncated, so every
-																	// content after the specified threshold will provide
-																	// the same ID.
-			{
-				// Extract a random content from the part of the catalog that has been aggregated, that is [name, cat_card].
-				name = std::floor((rand() / ((double)RAND_MAX+1))*(content_distribution::zipf.get_catalog_card() - name + 1) + name);
-			}
-		}*/
+		flow.srtt = rtt;
+		flow.rttvar = rtt / 2;
+	}
+	else
+	{
+		flow.rttvar = 0.75 * flow.rttvar + 0.25 * fabs(flow.srtt - rtt);
+		flow.srtt = 0.875 * flow.srtt + 0.125 * rtt;
+	}
+	flow.rto = max(min_rto, flow.srtt + 4 * flow.rttvar);
+	if (flow.min_rtt == 0 || rtt < flow.min_rtt)
+		flow.min_rtt = rtt;
 
+	rtt_sum += rtt;
+	rtt_samples++;
+}
 
-		struct download new_download = download (0,simTime() );
-		current_downloads.insert(pair<name_t, download >(name, new_download ) );
-		send_interest(name, 0 ,-1);
+/*
+ * 	Window update at the reception of the Data of an Interest ('rtt' is 0 if the Interest was
+ * 	retransmitted, i.e., without a valid RTT sample).
+ */
+void client_Window::open_window(window_flow &flow, double rtt)
+{
+	if (cc == CC_AIMD)
+	{
+		if (flow.cwnd < flow.ssthresh)
+			flow.cwnd += 1;					// Slow start.
+		else
+			flow.cwnd += 1. / flow.cwnd;	// Additive increase.
+	}
+	else if (rtt > 0)
+	{
+		double queued = flow.cwnd * (1 - flow.min_rtt / rtt);	// Interests queued inside the network.
+		if (queued < delay_alpha)
+			flow.cwnd += 1. / flow.cwnd;
+		else if (queued > delay_beta)
+			flow.cwnd -= 1. / flow.cwnd;
 	}
-	// Set the number of in-flights packets
-	inFlightPkts = currWinSize;
+	flow.cwnd = min(max(flow.cwnd, 1.), (double) maxWinSize);
 }
 
-
 /*
- *		Generate Interest packets according to an IRM process. Inter-request times are exponentially distributed
- *		with mean = 1/lambda.
- *
- *		Parameters:
- *		- cNum = class number ('0' for IRM clients).
+ * 	A Data packet acknowledges the chunks it carries for the Interests in flight of every download
+ * 	of that object (as Interests of the same object are aggregated by the PITs). Since a node may
+ * 	split a train into runs of cached and non-cached chunks, the Data of an Interest may come back
+ * 	in several parts: the Interest stays in flight until all its chunks are received.
  */
-void client_Window::request_file(unsigned long cNum)
+void client_Window::handle_incoming_chunk (ccn_data *data_message)
 {
-	//name_t name = content_distribution::zipf.value(dblrand());
-	name_t name = content_distribution::zipf[0]->sample();  // With Rejection-inversion sampling
+    cnumber_t chunk_num = data_message -> get_chunk_num();
+    name_t name = data_message -> get_name();
+    filesize_t size = data_message -> get_size();
+    int range = data_message -> getRange();		// Number of chunks carried (segment train).
+
+    int useful = 0;		// Chunks awaited by at least a download.
+    pair< multimap<name_t, window_flow>::iterator, multimap<name_t, window_flow>::iterator > ii = flows.equal_range(name);
+    for (multimap<name_t, window_flow>::iterator it = ii.first; it != ii.second; )
+    {
+    	window_flow &flow = it->second;
+    	int received = 0;
+
+    	// Interests in flight overlapping [chunk_num, chunk_num+range) (trains of a download are disjoint).
+    	map<cnumber_t, pending_interest>::iterator p = flow.in_flight.upper_bound(chunk_num + range - 1);
+    	while (p != flow.in_flight.begin())
+    	{
+    		--p;
+    		if (p->first + p->second.range <= chunk_num)
+    			break;
+
+    		int offset = (int) chunk_num - (int) p->first;
+    		uint64_t carried = (offset >= 0) ? train_mask(offset, range) : train_mask(0, range + offset);
+    		uint64_t arrived = p->second.missing & carried;
+    		if (!arrived)
+    			continue;		// Duplicate (e.g., after a retransmission).
+
+    		received += __builtin_popcountll(arrived);
+    		p->second.missing &= ~arrived;
+
+    		double rtt = 0;
+    		if (!p->second.retransmitted)
+    		{
+    			rtt = SIMTIME_DBL(simTime()) - SIMTIME_DBL(p->second.sent);
+    			rtt_sample(flow, rtt);
+    		}
+    		if (!p->second.missing)
+    		{
+    			p = flow.in_flight.erase(p);
+    			open_window(flow, rtt);
+    		}
+    	}
+    	if (!received)
+    	{
+    		++it;
+    		continue;
+    	}
+    	flow.received += received;
+    	useful = max(useful, received);
+
+    	// Download tracker.
+    	multimap<name_t, download>::iterator d = current_downloads.find(name);
+    	if (flow.received >= size)
+    	{
+    		simtime_t completion_time = simTime()-flow.start;
+    		avg_time = (tot_chunks * avg_time + completion_time ) * 1./( tot_chunks+1 );
+    		if (d != current_downloads.end())
+    			current_downloads.erase(d);
+    		flows.erase(it++);
+    		continue;
+    	}
+    	if (d != current_downloads.end())
+    	{
+    		d->second.chunk = flow.received;
+    		d->second.last = simTime();
+    	}
+    	fill_window(name, flow);
+    	++it;
+    }
 
-	/*// ****  NB - COMMENT with Rejection-Inversion sampling
-	// Check if the catalog aggregation is active. In this case, request for less popular contents
-	// after a specified percentile are generated by randomly selecting an ID within that range.
-	if (content_distribution::zipf.get_perc_aggr() < 1.0)
+    if (useful)
+    {
+    	// Every chunk of a segment train counts as a separate chunk.
+    	avg_distance = (tot_chunks*avg_distance+useful*data_message->getHops())/(tot_chunks+useful);
+    	tot_downloads+=(double)useful/size;
+    	tot_chunks+=useful;
+    }
+}
+
+/*
+ * 	Retransmission of the Interests in flight for more than the RTO of their download. A timeout
+ * 	decreases the window (once per check, whatever the number of expired Interests) and doubles
+ * 	the RTO until a new RTT sample is taken.
+ */
+void client_Window::handle_timers(cMessage *)
+{
+	double now = SIMTIME_DBL(simTime());
+	for (multimap<name_t, window_flow>::iterator it = flows.begin(); it != flows.end(); ++it)
 	{
-		if (name == content_distribution::zipf.get_ID_aggr()+1) // In case of catalog aggregation, the vector
-																// containing the Zipf cdf is truncated, so every
-																// content after the specified threshold will provide
-																// the same ID.
-		{
-			// Extract a random content from the part of the catalog that has been aggregated, that is [name, cat_card].
-			name = std::floor((rand() / ((double)RAND_MAX+1))*(content_distribution::zipf.get_catalog_card() - name + 1) + name);
-	    }
-	}*/
-
-	struct download new_download = download (0,simTime() );
-	#ifdef SEVERE_DEBUG
-	new_download.serial_number = interests_sent;
-
-	if (!active){
-		std::stringstream ermsg;
-		ermsg<<"Client attached to node "<< getNodeIndex() <<" is requesting file but it "
-			<<"shoud not as it is not active";
-		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-	}
+		window_flow &flow = it->second;
+		bool expired = false;
+		for (map<cnumber_t, pending_interest>::iterator p = flow.in_flight.begin(); p != flow.in_flight.end(); ++p)
+			if (now - SIMTIME_DBL(p->second.sent) > flow.rto)
+			{
+				// Each run of missing chunks is requested again. The Interest invalidates the PIT
+				// entries on its path (Nfound), otherwise it would be aggregated to them.
+				uint64_t missing = p->second.missing;
+				while (missing)
+				{
+					int first = __builtin_ctzll(missing);
+					uint64_t run = ~(missing >> first);
+					int length = run ? __builtin_ctzll(run) : MAX_TRAIN - first;
+					resend_interest(it->first, p->first + first, -1, length);
+					missing &= ~train_mask(first, length);
+				}
+				p->second.sent = simTime();
+				p->second.retransmitted = true;
+				expired = true;
+			}
 
-	if (getNodeIndex() == 18){
-		std::stringstream ermsg;
-		ermsg<<"I am node "<< getNodeIndex() <<" and I am requesting a file";
-		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		if (expired)
+		{
+			timeouts++;
+			flow.ssthresh = max(flow.cwnd * md_factor, 1.);
+			flow.cwnd = flow.ssthresh;
+			flow.rto = min(2 * flow.rto, MAX_RTO);
+		}
 	}
-	#endif
-
-	current_downloads.insert(pair<name_t, download >(name, new_download ) );
-	send_interest(name, 0 ,-1);
 }
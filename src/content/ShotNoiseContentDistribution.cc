@@ -45,8 +45,6 @@ void ShotNoiseContentDistribution::initialize()
 	cout << "Initialize SHOT NOISE content distribution...\tTime:\t" << SimTime() << "\n";
 
 	classInfo = new vector<classInfoEntry> ();
-	state_flags = new boost::dynamic_bitset<> ();
-	state_times = new vector<simtime_t>	();
 
 	const char *fileName = par("shot_noise_file").stringValue();	// Read the configuration file name.
 	tOffMultFactor = par("toff_mult_factor");						// Read the Toff multiplicative factor.
@@ -56,7 +54,7 @@ void ShotNoiseContentDistribution::initialize()
 	// Read configuration file.
 	import_catalog_features(fileName);
 
-	// Initialize both State Flags and Transition Times for each content.
+	// Initialize the ON/OFF processes and the popularity distributions of each class.
 	initialize_contents();
 
 	content_distribution::initialize();
@@ -69,8 +67,8 @@ void ShotNoiseContentDistribution::initialize()
 void ShotNoiseContentDistribution::finish()
 {
 	delete classInfo;
-	delete state_flags;
-	delete state_times;
+	for (uint32_t i=0; i<schedules.size(); i++)
+		delete schedules[i];
 	for (uint32_t i=0; i<zipfClasses.size(); i++)
 		delete zipfClasses[i];
 }
@@ -187,39 +185,25 @@ void ShotNoiseContentDistribution::import_catalog_features(const char* path)
 }
 
 /*
- *  Initialize State flags and the initial Transition Times for each content.
+ *  Initialize the ON/OFF processes of the classes. The state of each content is derived on demand
+ *  by the schedule of its class, so no per-content state is kept.
  */
 void ShotNoiseContentDistribution::initialize_contents()
 {
 	// If Ton_i > steadySimTime for class 'i', the respective contents will be always ON.
-	// Therefore, they will be not modeled as part of the ON-OFF process (i.e., state_flags
-	// and state_times will not be initialized).
-
-	// Calculate the number of contents worth to be simulated as ON-OFF.
-	long double onOffContents = 0;
+	// Therefore, they will be not modeled as part of the ON-OFF process.
+	ccn_rng seeder(this, 0);
 	for (uint32_t i=0; i<classInfo->size(); i++)
 	{
-		if (classInfo->operator [](i).ton < steadySimTime)
-			onOffContents += classInfo->operator [](i).numContents;
-		else
-			break;
-	}
-
-	// Initialize the vector containing the State flags (initially all the contents are ON).
-	state_flags->resize(onOffContents, true);
-
-	// Initializing the vector containing the Transition Times.
-	state_times->resize(onOffContents);
-
-	int i=0;
-	for(uint32_t j=1; j<=onOffContents; j++)
-	{
-		state_times->operator[](j-1) = (simtime_t)exponential(classInfo->operator [](i).ton);
-		if(j==classInfo->operator [](i).lessPopular)
+		classInfoEntry &cl = classInfo->operator [](i);
+		if (cl.ton < steadySimTime)
 		{
-			cout << "Class:\t" << i+1 << "\tContent:\t" << j << "\tTransition Time:\t" << state_times->operator[](j-1) << "\n";
-			++i;  	// Use the parameters of the subsequent content class.
+			// Each class draws its own seed from the network 'rng_seed'.
+			uint64_t seed = (uint64_t)(seeder.uniform() * 9007199254740992.0);
+			schedules.push_back(new onoff_schedule(SIMTIME_DBL(cl.ton), SIMTIME_DBL(cl.toff), seed));
 		}
+		else
+			schedules.push_back(NULL);
 	}
 
 	// Initialize the structure containing the Zipf distributions for all the classes.
@@ -242,81 +226,34 @@ void ShotNoiseContentDistribution::initialize_contents()
 }
 
 /*
- * 	Set the state of the specified content as "ON".
+ * 	Return the class of the specified content.
  *
  * 	Parameters:
- * 	- contentID: ID of the specified content.
+ * 	- contentID: ID of the specified content (starting from 0).
  */
-void ShotNoiseContentDistribution::set_state_flag(int contentID)
+int ShotNoiseContentDistribution::find_class(int contentID)
 {
-	if ((uint32_t)contentID < state_flags->size())
-		state_flags->operator[](contentID) = 1;
-	else
-		cout << "Trying to set the state flag of a non existent content!\n";
+	for (int i=0; i<numOfClasses; i++)
+		if ((uint32_t)contentID < classInfo->operator [](i).lessPopular)
+			return i;
+	return -1;
 }
 
 /*
- * 	Set the state of the specified content as "OFF".
+ * 	Check the state of the specified content at the current simulation time.
  *
  * 	Parameters:
- * 	- contentID: ID of the specified content.
- */
-void ShotNoiseContentDistribution::unset_state_flag(int contentID)
-{
-	if ((uint32_t)contentID < state_flags->size())
-		state_flags->operator[](contentID) = 0;
-	else
-		cout << "Trying to unset the state flag of a non existent content!\n";
-}
-
-/*
- * 	Check the state of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
+ * 	- contentID: ID of the specified content (starting from 0).
  */
 bool ShotNoiseContentDistribution::check_state_flag(int contentID)
 {
-	bool active = false;
-	if ((uint32_t)contentID < state_flags->size())
+	int c = find_class(contentID);
+	if (c < 0)
 	{
-		if(state_flags->operator[](contentID) == 1)
-		active = true;
-	}
-	else
 		cout << "Trying to check the state flag of a non existent content!\n";
-	return active;
-
-}
-
-/*
- * 	Set the transition time of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
- * 	- timeStamp: new transition time for contentID.
- */
-void ShotNoiseContentDistribution::set_state_time(int contentID, simtime_t timeStamp)
-{
-	if ((uint32_t)contentID < state_flags->size())
-		state_times->operator[](contentID) = timeStamp;
-	else
-		cout << "Trying to set the transition time of a non existent content!\n";
-}
-
-/*
- * 	Check the transition time of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
- */
-simtime_t ShotNoiseContentDistribution::get_state_time(int contentID)
-{
-	simtime_t temp;
-	if ((uint32_t)contentID < state_flags->size())
-		temp = state_times->operator[](contentID);
-	else
-		cout << "Trying to get the transition time of a non existent content!\n";
-	return temp;
+		return false;
+	}
+	if (schedules[c] == NULL)
+		return true;
+	return schedules[c]->is_on(contentID, SIMTIME_DBL(simTime()));
 }
-
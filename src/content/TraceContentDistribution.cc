@@ -0,0 +1,86 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "ccnsim.h"
+#include "TraceContentDistribution.h"
+#include "content_distribution.h"
+#include <error_handling.h>
+
+Register_Class(TraceContentDistribution);
+
+void TraceContentDistribution::initialize()
+{
+	cout << "Initialize TRACE content distribution...\tTime:\t" << SimTime() << "\n";
+
+	const char *fileName = par("trace_file").stringValue();
+	string error;
+	if (!trace.open(fileName, error))
+	{
+		std::stringstream ermsg;
+		ermsg<<error<<". Please convert the request log with scripts/trace_convert.cc";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	int num_clients = getAncestorPar("num_clients");
+	if (trace.get_num_clients() > (uint32_t) num_clients)
+	{
+		std::stringstream ermsg;
+		ermsg<<"The trace contains "<<trace.get_num_clients()<<" clients, while only "<<num_clients<<
+				" clients are simulated. Please fold the clients of the trace with the '-n' option of trace_convert.";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	cModule* pSubModStat = getParentModule()->getSubmodule("statistics");
+	long down = pSubModStat->par("downsize");
+	if (down != 1)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Request traces cannot be downscaled (downsize="<<down<<"). Please set downsize=1.";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	cout << "Trace requests:\t" << trace.get_num_records() << "\n";
+	cout << "Trace contents:\t" << trace.get_num_contents() << "\n";
+	cout << "Trace clients:\t" << trace.get_num_clients() << "\n";
+	cout << "Trace duration:\t" << trace.get_duration() << " s\n";
+
+	content_distribution::initialize();
+}
+
+void TraceContentDistribution::finish()
+{
+	trace.close();
+}
+
+// The size of each content is the largest one requested inside the trace.
+filesize_t TraceContentDistribution::file_size(name_t d)
+{
+	return trace.get_content_size(d);
+}
@@ -31,6 +31,7 @@
 #include "ccnsim.h"
 #include "content_distribution.h"
 #include "ShotNoiseContentDistribution.h"
+#include "TraceContentDistribution.h"
 #include "zipf.h"
 #include "zipf_sampled.h"
 #include <algorithm>
@@ -82,7 +83,18 @@ void content_distribution::initialize()
     if (pSubModule)
     {
     	ShotNoiseContentDistribution* pClass2Module = dynamic_cast<ShotNoiseContentDistribution*>(pSubModule);
-    	if (!pClass2Module)     	// If the SNM is NOT simulated.
+    	TraceContentDistribution* pTraceModule = dynamic_cast<TraceContentDistribution*>(pSubModule);
+    	if (pTraceModule)			// A request trace is replayed: the catalog is the one of the trace.
+    	{
+    		cardF = pTraceModule->trace.get_num_contents();
+    		newCardF = cardF;
+    		cout << "Trace CARDINALITY: " << cardF << endl;
+    		lambda = pSubModStat->par("lambda");
+
+    		zipf.resize(1);
+    		zipf[0] = new zipf_sampled((unsigned long long)newCardF,alpha,lambda,1);  // Only used by the model-based cache filling.
+    	}
+    	else if (!pClass2Module)     	// If the SNM is NOT simulated.
     	{
     		// Take parameters from the .ini file
 
@@ -282,13 +294,7 @@ void content_distribution::init_content()
 		// Reset the information field of a given content
 		__info(d) = 0;
 
-		// F is the size of a file.
-		if (F > 1){
-			// Set the file size (geometrically distributed).
-			filesize_t s = geometric( 1.0 / F ) + 1;
-			__ssize ( d, s );
-		}else 
-			__ssize( d , 1);
+		__ssize ( d, file_size(d) );
 
 		vector<int> chosen_repos; 
 
@@ -336,6 +342,20 @@ void content_distribution::init_content()
 	}
 }
 
+/*
+ * 	Size of a content, expressed in chunks. By default, it is geometrically distributed
+ * 	with mean F (i.e., the file_size parameter).
+ *
+ * 	Parameters:
+ * 		- d: content ID.
+ */
+filesize_t content_distribution::file_size(name_t d)
+{
+	if (F > 1)
+		return geometric( 1.0 / F ) + 1;
+	return 1;
+}
+
 /*
 * Initialize the repositories vector. This vector is composed of the
 * repositories specified in the ini file.  In addition some random repositories
@@ -0,0 +1,166 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "onoff_schedule.h"
+#include "ccn_rng.h"
+#include <cmath>
+#include <algorithm>
+
+onoff_schedule::onoff_schedule(double _ton, double _toff, uint64_t _seed):ton(_ton),toff(_toff),seed(_seed)
+{
+	for(int i=0; i < CACHE_SLOTS; i++)
+		cache[i].contentID = UINT64_MAX;
+}
+
+/*
+ * 	Gamma(shape, 1) variate of the given epoch (Marsaglia-Tsang method, shape >= 1). Every variate of an
+ * 	epoch has its own stream of the counter-based generator, and each attempt takes a single block of
+ * 	it: 53 bits for the radius and 32 bits for the angle of the normal variate (Box-Muller), and 32 bits
+ * 	for the acceptance test.
+ */
+double onoff_schedule::gamma(uint64_t contentID, uint64_t epoch, uint64_t variate, double shape) const
+{
+	const double d = shape - 1./3;
+	const double c = 1./sqrt(9*d);
+	for(uint32_t attempt=0; ; attempt++)
+	{
+		uint32_t w[4];
+		ccn_rng::block(seed, (uint32_t)contentID, (uint32_t)variate, (epoch << 32) | attempt, w);
+		double u1 = (double)((((uint64_t)w[0] << 32) | w[1]) >> 11) + 0.5;
+		u1 *= 1.0 / 9007199254740992.0;
+		double u2 = (w[2] + 0.5) * (1.0 / 4294967296.0);
+		double u = (w[3] + 0.5) * (1.0 / 4294967296.0);
+
+		double x = sqrt(-2*log(u1)) * cos(2*M_PI*u2);
+		double v = 1 + c*x;
+		if(v <= 0)
+			continue;
+		v = v*v*v;
+		if(u < 1 - 0.0331*x*x*x*x || log(u) < 0.5*x*x + d - d*v + d*log(v))
+			return d*v;
+	}
+}
+
+/*
+ * 	Fraction of the ON time of a group of 'cycles' cycles (node of the bisection of an epoch) which
+ * 	belongs to its first half, i.e., a Beta(cycles/2, cycles/2) variate. For small groups it is drawn
+ * 	as the median of cycles-1 uniform numbers (an order statistic, 4 per block of the generator),
+ * 	otherwise as the ratio of two Gamma variates.
+ */
+double onoff_schedule::split(uint64_t contentID, uint64_t epoch, uint64_t node, int cycles) const
+{
+	int half = cycles / 2;
+	if(half <= 4)
+	{
+		double u[7];
+		int n = cycles - 1;
+		for(int i=0; i < n; i += 4)
+		{
+			uint32_t w[4];
+			ccn_rng::block(seed, (uint32_t)contentID, (uint32_t)(2*node), (epoch << 32) | (i/4), w);
+			for(int j=0; j < 4 && i+j < n; j++)
+				u[i+j] = (w[j] + 0.5) * (1.0 / 4294967296.0);
+		}
+		for(int i=1; i < n; i++)		// Insertion sort (at most 7 numbers).
+			for(int j=i; j > 0 && u[j] < u[j-1]; j--)
+				swap(u[j], u[j-1]);
+		return u[half-1];
+	}
+	double left = gamma(contentID, epoch, 2*node, half);
+	double right = gamma(contentID, epoch, 2*node + 1, half);
+	return left / (left + right);
+}
+
+/*
+ * 	Bisection of a group of cycles containing t, down to the group of the given number of cycles
+ * 	containing it.
+ */
+void onoff_schedule::bisect(uint64_t contentID, double t, int cycles, cycle_group &g) const
+{
+	while(g.cycles > cycles)
+	{
+		double left = g.on_time * split(contentID, g.epoch, g.node, g.cycles);
+		g.cycles /= 2;
+		double end = g.start + left + g.cycles*toff;	// End of the first half.
+		if(t < end)
+		{
+			g.on_time = left;
+			g.node = 2*g.node;
+		}
+		else
+		{
+			g.start = end;
+			g.on_time -= left;
+			g.node = 2*g.node + 1;
+		}
+	}
+}
+
+/*
+ * 	Check whether the content is ON at time t.
+ *
+ * 	Parameters:
+ * 	- contentID: ID of the content;
+ * 	- t: time of the query.
+ */
+bool onoff_schedule::is_on(uint64_t contentID, double t) const
+{
+	if(toff <= 0)
+		return true;
+
+	located_block &slot = cache[contentID % CACHE_SLOTS];
+	cycle_group &b = slot.block;
+	if(slot.contentID != contentID || t < b.start || t >= b.start + b.on_time + BLOCK*toff)
+	{
+		// Find the epoch containing t, starting from the one of the previous query of the content.
+		if(slot.contentID != contentID || t < slot.epoch_start)
+		{
+			slot.contentID = contentID;
+			b.epoch = 0;
+			slot.epoch_start = 0;
+			slot.epoch_on_time = ton * gamma(contentID, 0, 0, EPOCH);
+		}
+		while(t >= slot.epoch_start + slot.epoch_on_time + EPOCH*toff)
+		{
+			slot.epoch_start += slot.epoch_on_time + EPOCH*toff;
+			b.epoch++;
+			slot.epoch_on_time = ton * gamma(contentID, b.epoch, 0, EPOCH);
+		}
+		b.node = 1;
+		b.cycles = EPOCH;
+		b.start = slot.epoch_start;
+		b.on_time = slot.epoch_on_time;
+		bisect(contentID, t, BLOCK, b);
+	}
+
+	cycle_group cycle = b;
+	bisect(contentID, t, 1, cycle);
+	return t < cycle.start + cycle.on_time;		// ON period of the cycle, then its OFF period.
+}
@@ -0,0 +1,160 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "trace_file.h"
+#include <sstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+trace_file::trace_file():base(NULL),length(0),header(NULL),sizes(NULL),index(NULL),records(NULL)
+{
+}
+
+trace_file::~trace_file()
+{
+	close();
+}
+
+/*
+ * 	Map the trace in memory and check its consistency.
+ *
+ * 	Parameters:
+ * 		- file_name: binary trace.
+ * 		- error: reason of the failure (if false is returned).
+ */
+bool trace_file::open(const char *file_name, string &error)
+{
+	stringstream msg;
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+	if (fd < 0)
+	{
+		msg << "Impossible to open the trace file " << file_name;
+		error = msg.str();
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(trace_header))
+	{
+		::close(fd);
+		msg << "The trace file " << file_name << " is too short";
+		error = msg.str();
+		return false;
+	}
+	length = st.st_size;
+
+	base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);		// The mapping keeps the file referenced.
+	if (base == MAP_FAILED)
+	{
+		base = NULL;
+		msg << "Impossible to map the trace file " << file_name;
+		error = msg.str();
+		return false;
+	}
+
+	// Records are read sequentially (per client): read-ahead is useful, while
+	// keeping replayed pages around is not.
+	madvise(base, length, MADV_SEQUENTIAL);
+
+	const char *p = (const char *) base;
+	header = (const trace_header *) p;
+	if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 || header->version != TRACE_VERSION)
+		msg << file_name << " is not a ccnSim trace (or it has been produced by a different version of trace_convert)";
+	else if (header->record_size != sizeof(trace_record))
+		msg << "Records of " << file_name << " are " << header->record_size << " bytes long instead of " << sizeof(trace_record);
+	else if (header->sizes_offset + header->num_contents * sizeof(uint16_t) > length ||
+			header->index_offset + (header->num_clients + 1) * sizeof(uint64_t) > length ||
+			header->records_offset + header->num_records * sizeof(trace_record) > length)
+		msg << "The trace file " << file_name << " is truncated";
+	else
+	{
+		// Sections of the clients must be contiguous ranges of records (see section_begin/end).
+		index = (const uint64_t *) (p + header->index_offset);
+		for (uint32_t k = 0; k <= header->num_clients && msg.str().empty(); k++)
+			if (index[k] > header->num_records || (k > 0 && index[k] < index[k-1]))
+				msg << "The client index of " << file_name << " is corrupted (entry " << k << ")";
+	}
+
+	if (!msg.str().empty())
+	{
+		error = msg.str();
+		close();
+		return false;
+	}
+
+	sizes = (const uint16_t *) (p + header->sizes_offset);
+	records = (const trace_record *) (p + header->records_offset);
+	return true;
+}
+
+void trace_file::close()
+{
+	if (base)
+		munmap(base, length);
+	base = NULL;
+	length = 0;
+	header = NULL;
+	sizes = NULL;
+	index = NULL;
+	records = NULL;
+}
+
+/*
+ * 	Ask the kernel to load the pages containing the records in [from, to).
+ */
+void trace_file::prefetch(const trace_record *from, const trace_record *to) const
+{
+	if (from >= to)
+		return;
+	static const uintptr_t page = sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t) from & ~(page - 1);
+	uintptr_t end = (uintptr_t) to;
+	madvise((void *) start, end - start, MADV_WILLNEED);
+}
+
+/*
+ * 	Drop the pages entirely filled by already replayed records in [from, to).
+ */
+void trace_file::release(const trace_record *from, const trace_record *to) const
+{
+	static const uintptr_t page = sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t) from + page - 1) & ~(page - 1);
+	uintptr_t end = (uintptr_t) to & ~(page - 1);
+	if (start < end)
+		madvise((void *) start, end - start, MADV_DONTNEED);
+}
@@ -57,13 +57,17 @@ void zipf_sampled::zipf_sampled_initialize()
     	return;
 }
 
-unsigned long long zipf_sampled::sample()
+unsigned long long zipf_sampled::sample(ccn_rng *rng)
 {
-    while(true)
+    // With a counter-based stream, the variate takes a single counter and its retries are drawn from it.
+    uint64_t ctr = rng ? rng->next_variate() : 0;
+    for (uint32_t attempt = 0; ; attempt++)
     {
     	// Double RNG compatible with both omnet-4x and omnet-5x
     	double rd;
-    	if(cSimulation::getActiveSimulation()->getContext())
+    	if(rng)
+    		rd = rng->variate_uniform(ctr, attempt);
+    	else if(cSimulation::getActiveSimulation()->getContext())
     		rd = cSimulation::getActiveSimulation()->getContext()->getRNG(0)->doubleRand();
     	else
     		rd = cSimulation::getActiveEnvir()->getRNG(0)->doubleRand();
@@ -128,6 +132,12 @@ unsigned long long zipf_sampled::sample()
     }
 }
 
+void zipf_sampled::sample(ccn_rng &rng, unsigned long long *out, size_t n)
+{
+	for(size_t i=0; i < n; i++)
+		out[i] = sample(&rng);
+}
+
 double zipf_sampled::hIntegral(double x)
 {
     double logX = log(x);
@@ -42,6 +42,7 @@
 #include "costaware_policy.h"
 #include "ideal_costaware_policy.h"
 #include "error_handling.h"
+#include "results_sink.h"
 
 #include "two_lru_policy.h"
 #include "two_ttl_policy.h"
@@ -52,6 +53,8 @@
 #include "decision_policy.h"
 #include "betweenness_centrality.h"
 #include "prob_cache.h"
+#include "tinylfu_policy.h"
+#include "request_log.h"
 
 #include "ccnsim.h"
 
@@ -65,6 +68,28 @@ void base_cache::initialize()
     cache_size = par("C");
 	decisor = NULL;
 
+	int tc_sampling = par("tc_sampling");	// Log one eviction every tc_sampling (0 = no Tc measurement).
+	if (tc_sampling < 0)
+	{
+		std::stringstream ermsg;
+		ermsg<<"tc_sampling must be >= 0. Please check.";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	tc_meter.set_sampling(tc_sampling);
+
+	// Per-node binary log of the requests (for offline bounds, see scripts/belady.cc).
+	req_log = NULL;
+	string log_prefix = par("request_log").stdstringValue();
+	if (!log_prefix.empty())
+	{
+		std::stringstream log_name;
+		log_name<<log_prefix<<"_"<<getIndex()<<".rlog";
+		string error;
+		req_log = new request_log();
+		if (!req_log->open(log_name.str().c_str(), getIndex(), cache_size, error))
+			severe_error(__FILE__,__LINE__,error.c_str() );
+	}
+
 	// Retrieve replacement policy (i.e., TTL vs ALL)
 	string forwStr = getParentModule()->par("RS");
 	if(forwStr.compare("ttl_cache") == 0)		// We have to retrieve the Tc value of the node from the correspondent file
@@ -108,12 +133,15 @@ void base_cache::initialize()
 	{
 		TC_NAME_PATH = par("tc_name_file");
 		read_tc_name_value();
-		decisor = new Two_TTL(tc_name_node);
+		if (compact_name_cache_generations() > 0)
+			decisor = new Two_TTL(tc_name_node, (int)par("NC"), compact_name_cache_generations());
+		else
+			decisor = new Two_TTL(tc_name_node);
 	}
 	else if (decision_policy.compare("two_lru")==0)			// 2-LRU: set the size of the name cache
 	{
 		name_cache_size = par("NC");
-		decisor = new Two_Lru(name_cache_size);
+		decisor = new Two_Lru(name_cache_size, compact_name_cache_generations());
 	}
 	else if (decision_policy.find("btw")==0)				// Betweenness centrality
 	{
@@ -126,6 +154,16 @@ void base_cache::initialize()
 	{
 		decisor = new prob_cache(cache_size);
     }
+	else if (decision_policy.compare("tinylfu")==0)			// TinyLFU: frequency-sketch admission
+	{
+		uint64_t counters = (int)par("sketch_counters");
+		uint64_t sample = (int)par("sketch_sample");
+		if (counters == 0)
+			counters = 4 * (uint64_t)cache_size;
+		if (sample == 0)
+			sample = 10 * (uint64_t)cache_size;
+		decisor = new TinyLFU(this, counters, sample, par("doorkeeper").boolValue());
+	}
 	else if (decision_policy.find("never")==0)				// Never
 	{
 		decisor = new Never();
@@ -178,32 +216,36 @@ void base_cache::initialize()
 
 void base_cache::finish(){
 
-    char name [30];
-    sprintf ( name, "p_hit[%d]", getIndex());
-    recordScalar (name, hit * 1./(hit+miss));		// Record average hit rate.
-
-
-    sprintf ( name, "hits[%d]", getIndex());		// Record number of hits.
-    recordScalar (name, hit );
-
+    record_result(this, "node", getIndex(), "p_hit", hit * 1./(hit+miss));		// Record average hit rate.
+    record_result(this, "node", getIndex(), "hits", hit);						// Record number of hits.
+    record_result(this, "node", getIndex(), "misses", miss);					// Record number of misses.
+    record_result(this, "node", getIndex(), "decision_yes", decision_yes);
+    record_result(this, "node", getIndex(), "decision_no", decision_no);
 
-    sprintf ( name, "misses[%d]", getIndex());		// Record number of misses.
-    recordScalar (name, miss);
-
-    sprintf ( name, "decision_yes[%d]", getIndex());
-    recordScalar (name, decision_yes);
-
-    sprintf ( name, "decision_no[%d]", getIndex());
-    recordScalar (name, decision_no);
-
-    sprintf ( name, "decision_ratio[%d]", getIndex());
 	double decision_ratio = (decision_yes + decision_no == 0 ) ?
 			0 : (double)decision_yes / (decision_yes + decision_no) ; 
-    recordScalar (name, decision_ratio);
+    record_result(this, "node", getIndex(), "decision_ratio", decision_ratio);
 
 	decisor->finish(getIndex(), this);
 
+	if (tc_meter.samples() > 0)
+		tc_meter.record(this, getIndex());
+
+	if (req_log != NULL)
+	{
+		bool written = req_log->close();
+		delete req_log;
+		req_log = NULL;
+		if (!written)
+		{
+			std::stringstream ermsg;
+			ermsg<<"The request log of cache "<<getIndex()<<" is incomplete (write error)";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+	}
+
     //Per file hit rate
+    //char name [30];
     //sprintf ( name, "hit_node[%d]", getIndex());
     //cOutVector hit_vector(name);
     //for (uint32_t f = 1; f <= __file_bulk; f++)
@@ -225,22 +267,36 @@ void base_cache::finish(){
  */
 void base_cache::store(cMessage *in)
 {
+	ccn_data* data = (ccn_data*) in;
+	int range = data->getRange();
+
 	if (cache_size ==0)		// The cache has Size=0.
 	{
-		after_discarding_data();
+		for (int k = 0; k < range; k++)
+			after_discarding_data();
 		return;
 	}
 
-    if (decisor->data_to_cache((ccn_data*)in )) 	// The decision is based on the meta-caching strategy.
-    {
-		decision_yes++;
-		data_store( ( (ccn_data* ) in )->getChunk() ); // Store the received chunk inside the local cache. It is implemented
-													   // by each derived class according to the chosen replacement policy.
-		decisor->after_insertion_action();
+	// A segment train carries 'range' consecutive chunks: each of them is subject to its own
+	// meta-caching decision, exactly as if it had arrived in a separate Data packet.
+	chunk_t first = data->getChunk();
+	for (int k = 0; k < range; k++)
+	{
+		if (range > 1)
+			data->setChunk(nth_chunk(first, k));
+
+		if (decisor->data_to_cache(data)) 	// The decision is based on the meta-caching strategy.
+		{
+			decision_yes++;
+			data_store( data->getChunk() ); // Store the received chunk inside the local cache. It is implemented
+											// by each derived class according to the chosen replacement policy.
+			decisor->after_insertion_action();
+		}
+		//<aa>
+		else after_discarding_data();
+		//</aa>
 	}
-	//<aa>
-	else after_discarding_data();
-	//</aa>
+	data->setChunk(first);
 }
 
 //<aa>
@@ -286,6 +342,11 @@ bool base_cache::lookup(chunk_t chunk )
     bool found = false;
     //name_t name = __id(chunk);
 
+    decisor->after_lookup_action(chunk);
+
+    if (req_log != NULL)
+    	req_log->append(chunk);
+
     if (data_lookup(chunk))		// The requested content is cached locally.
     {
     	hit++;
@@ -310,6 +371,35 @@ bool base_cache::lookup(chunk_t chunk )
     return found;
 }
 
+/*
+ * 		Lookup of a segment train, i.e., of 'range' consecutive chunks starting from 'chunk'.
+ * 		Every chunk is looked up individually, so that hit/miss statistics are the same as
+ * 		those of 'range' separate Interests.
+ *
+ * 		Parameters:
+ * 			- chunk: first chunk of the train.
+ * 			- range: number of chunks of the train (at most MAX_TRAIN).
+ *
+ * 		Returns a bitmask whose k-th bit is set iff the k-th chunk of the train is cached.
+ */
+uint64_t base_cache::lookup_train(chunk_t chunk, int range)
+{
+	#ifdef SEVERE_DEBUG
+	if (range < 1 || range > MAX_TRAIN)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Segment train of "<<range<<" chunks: it must be in [1,"<<MAX_TRAIN<<"]";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	#endif
+
+	uint64_t hits = 0;
+	for (int k = 0; k < range; k++)
+		if (lookup(nth_chunk(chunk, k)))
+			hits |= (uint64_t)1 << k;
+	return hits;
+}
+
 double base_cache::get_tc()
 {
 	double tc = get_tc_node();
@@ -340,6 +430,34 @@ bool base_cache::fake_lookup(chunk_t chunk)
     return data_lookup(chunk);
 }
 
+/*
+ * 	Eviction candidate API. A replacement engine that knows in advance which
+ * 	chunk its next data_store() would replace overrides eviction_candidate(),
+ * 	so that decision policies (Ideal, cost-aware, TinyLFU) can compare the
+ * 	incoming chunk with the victim without knowing the engine. The default
+ * 	returns false, i.e., no candidate: that is also the answer of engines that
+ * 	never evict for capacity (e.g., TTL caches).
+ */
+bool base_cache::eviction_candidate(chunk_t &)
+{
+    return false;
+}
+
+bool base_cache::would_evict(chunk_t chunk, chunk_t &victim)
+{
+    return full() && !fake_lookup(chunk) && eviction_candidate(victim);
+}
+
+/*
+ * 	Engines whose descriptors have room for the cost of the cached objects (e.g., lru_pos) let the
+ * 	cost-aware policies annotate it there; the others return NULL and the policies keep the costs
+ * 	by themselves.
+ */
+double *base_cache::cost_slot(chunk_t)
+{
+    return NULL;
+}
+
 /*
  * 	Reset all the statistics.
  */
@@ -349,6 +467,9 @@ void base_cache::clear_stat()
 
 	decision_yes = decision_no = 0;
 
+	if (req_log != NULL)
+		req_log->mark_warmup();		// Offline bounds are computed on the requests logged from now on.
+
 	//**mt** DISABLED
     //delete [] cache_stats;
     //cache_stats = new cache_stat_entry[__file_bulk+1];
@@ -487,3 +608,20 @@ void base_cache::read_tc_name_value()
 		cout << "NODE # " << getIndex() << " has TC NAME = " << tc_name_node << " s" << endl;
 	}
 }
+
+/*
+ * 	Generations of the compact Name Cache of 2-LRU and 2-TTL, or 0 for the exact Name Cache.
+ */
+int base_cache::compact_name_cache_generations()
+{
+	string type = par("name_cache_type");
+	if (type.compare("exact")==0)
+		return 0;
+	if (type.compare("cuckoo")!=0)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Unknown name_cache_type "<<type<<". Use 'exact' or 'cuckoo'.";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	return par("name_cache_generations");
+}
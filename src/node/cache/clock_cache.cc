@@ -0,0 +1,249 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "clock_cache.h"
+#include "decision_policy.h"
+#include <iostream>
+
+#include "error_handling.h"
+
+
+Register_Class(clock_cache);
+
+const uint32_t clock_cache::EMPTY_BUCKET;
+
+void clock_cache::initialize()
+{
+	base_cache::initialize();
+	build();
+}
+
+/*
+ * 	Allocates the ring and the hash index according to the cache size. The index has
+ * 	at least twice as many buckets as the cache size (power of 2), so that linear probing
+ * 	sequences stay short.
+ */
+void clock_cache::build()
+{
+	uint32_t size = get_size();
+
+	ring.assign(size, clock_slot());
+	referenced.assign(size, 0);
+
+	uint64_t buckets = 2;
+	while (buckets < 2 * (uint64_t)size)
+		buckets <<= 1;
+	clock_bucket empty;
+	empty.k = 0;
+	empty.slot = EMPTY_BUCKET;
+	index.assign(buckets, empty);
+	index_mask = buckets - 1;
+
+	actual_size = 0;
+	hand = 0;
+}
+
+uint64_t clock_cache::bucket_of(chunk_t k) const
+{
+	// 64-bit finalizer (MurmurHash3), to spread the [name|number] pairs over the buckets.
+	uint64_t h = k;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h & index_mask;
+}
+
+/*
+ * 	Returns the position of the chunk inside the ring, or EMPTY_BUCKET if it is not cached.
+ */
+uint32_t clock_cache::index_find(chunk_t k) const
+{
+	for (uint64_t b = bucket_of(k); index[b].slot != EMPTY_BUCKET; b = (b + 1) & index_mask)
+		if (index[b].k == k)
+			return index[b].slot;
+	return EMPTY_BUCKET;
+}
+
+void clock_cache::index_insert(chunk_t k, uint32_t slot)
+{
+	uint64_t b = bucket_of(k);
+	while (index[b].slot != EMPTY_BUCKET)
+		b = (b + 1) & index_mask;
+	index[b].k = k;
+	index[b].slot = slot;
+}
+
+/*
+ * 	Removes the chunk from the index. Following entries of the same probing sequence are
+ * 	shifted backwards, so that no tombstones are needed.
+ */
+void clock_cache::index_erase(chunk_t k)
+{
+	uint64_t b = bucket_of(k);
+	while (index[b].k != k || index[b].slot == EMPTY_BUCKET)
+	{
+		#ifdef SEVERE_DEBUG
+		if (index[b].slot == EMPTY_BUCKET)
+		{
+			std::stringstream ermsg;
+			ermsg<<"Chunk "<<k<<" is not inside the index of the clock cache";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+		#endif
+		b = (b + 1) & index_mask;
+	}
+
+	uint64_t hole = b;
+	for (uint64_t next = (hole + 1) & index_mask; index[next].slot != EMPTY_BUCKET; next = (next + 1) & index_mask)
+	{
+		// The entry can fill the hole only if its home bucket does not lie in (hole, next].
+		uint64_t home = bucket_of(index[next].k);
+		if (((next - home) & index_mask) >= ((next - hole) & index_mask))
+		{
+			index[hole] = index[next];
+			hole = next;
+		}
+	}
+	index[hole].slot = EMPTY_BUCKET;
+}
+
+/*
+ * 	CLOCK storage handling. If the cache is not full, the new chunk takes the first free
+ * 	position. Otherwise, the hand sweeps the ring giving a second chance to referenced
+ * 	chunks, and the new chunk replaces the first unreferenced one.
+ *
+ * 	Parameters:
+ * 		- chunk: content object to be cached.
+ */
+void clock_cache::data_store(chunk_t chunk)
+{
+	if (ring.size() != get_size())		// The size of the cache has been changed (see set_size).
+		build();
+
+	if (index_find(chunk) != EMPTY_BUCKET)		// Already cached.
+		return;
+
+	uint32_t slot;
+	if (actual_size < get_size())
+		slot = actual_size++;
+	else
+	{
+		sweep();
+		slot = hand;
+		hand = (hand + 1 == ring.size()) ? 0 : hand + 1;
+
+		if (stability)
+			tc_meter.sample(SIMTIME_DBL(simTime()) - ring[slot].t);
+		index_erase(ring[slot].k);
+	}
+
+	ring[slot].k = chunk;
+	ring[slot].t = SIMTIME_DBL(simTime());
+	referenced[slot] = 0;
+	index_insert(chunk, slot);
+}
+
+/*
+ * 	Advance the hand, giving a second chance to referenced positions, until it
+ * 	points to the position that the next insertion replaces.
+ */
+void clock_cache::sweep()
+{
+	while (referenced[hand])
+	{
+		referenced[hand] = 0;
+		ring[hand].t = SIMTIME_DBL(simTime());		// Second chance.
+		hand = (hand + 1 == ring.size()) ? 0 : hand + 1;
+	}
+}
+
+/*
+ * 	Read-only: the chunk the next sweep would stop at, found on a local cursor (reference bits,
+ * 	times and hand are left untouched). If every position is referenced, the sweep clears them
+ * 	all and stops at the hand.
+ */
+bool clock_cache::eviction_candidate(chunk_t &victim)
+{
+	if (ring.size() != get_size() || actual_size < get_size())
+		return false;
+	uint32_t cursor = hand;
+	for (uint32_t n = 0; n < ring.size() && referenced[cursor]; n++)
+		cursor = (cursor + 1 == ring.size()) ? 0 : cursor + 1;
+	victim = ring[cursor].k;
+	return true;
+}
+
+/*
+ * 	CLOCK lookup. In case of a hit, only the reference bit is set.
+ */
+bool clock_cache::data_lookup(chunk_t chunk)
+{
+	uint32_t slot = index_find(chunk);
+	if (slot == EMPTY_BUCKET)	// The content object is not present inside the cache.
+		return false;
+
+	referenced[slot] = 1;
+	return true;
+}
+
+bool clock_cache::fake_lookup(chunk_t chunk)
+{
+	return index_find(chunk) != EMPTY_BUCKET;
+}
+
+bool clock_cache::full()
+{
+	return (actual_size == get_size());
+}
+
+double clock_cache::get_tc_node()
+{
+	return tc_meter.mean();
+}
+
+void clock_cache::finish()
+{
+	base_cache::finish();
+	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << tc_meter.mean() << endl;
+}
+
+void clock_cache::flush()
+{
+	build();
+	get_decisor()->after_flush();
+}
+
+void clock_cache::dump()
+{
+	for (uint32_t p = 0; p < actual_size; p++)
+		cout<<p+1<<" ]"<< __id(ring[p].k)<<"/"<<__chunk(ring[p].k)<<(referenced[p] ? " *" : "")<<endl;
+}
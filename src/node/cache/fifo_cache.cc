@@ -29,6 +29,7 @@
  *
  */
 #include "fifo_cache.h"
+#include "decision_policy.h"
 #include <iostream>
 
 #include "error_handling.h"
@@ -48,28 +49,14 @@ void fifo_cache::data_store(chunk_t chunk)
    }
    //cache[chunk] = true;
 
-   deq.push_back(chunk);
-
-   if(stability)
-   {
-	   map<chunk_t, double>::iterator it = monitored_contents.find(chunk);
-	   if(it == monitored_contents.end())
-	   {
-		   monitored_contents[chunk] = SIMTIME_DBL(simTime());
-		   //cout << "NODE # " << getParentModule()->getIndex() << " :caching content # " << elem << endl;
-	   }
-	   else
-	   {
-		   //cout << "The entry is present despite the previous miss event!\n";
-		   exit(1);
-	   }
-   }
+   deq.push_back(fifo_entry(chunk, SIMTIME_DBL(simTime())));		// The insertion time is kept for the Tc measurement.
 
 
    if ( deq.size() > get_size() )
    {
 	   //Eviction of the last element
-       chunk_t toErase = deq.front();
+       chunk_t toErase = deq.front().first;
+       double inserted = deq.front().second;
        deq.pop_front();
 
        cache[toErase] -= 1;
@@ -79,23 +66,7 @@ void fifo_cache::data_store(chunk_t chunk)
     	   cache.erase(toErase);
 
     	   if(stability)
-    	   {
-    		   map<chunk_t, double>::iterator it = monitored_contents.find(toErase);
-    		   if(it == monitored_contents.end())
-    		   {
-    			   //cout << simTime() << " NODE # " << getParentModule()->getIndex() << " :Cannot log Tc: entry for content # " << k << " is not present!\n";
-    			   //	exit(1);
-    		   }
-    		   else
-    		   {
-    			   double Tc  = SIMTIME_DBL(simTime()) - monitored_contents[toErase];
-    			   monitored_contents.erase(toErase);
-    			   //int nodeId = getParentModule()->getIndex();
-    			   //cout << simTime() << "\tNODE\t" << nodeId << "\tContent\t" << k << "\tTc\t" << Tc << endl;
-    			   nodeTc += Tc;
-    			   tcSamples++;
-    		   }
-    	   }
+    		   tc_meter.sample(SIMTIME_DBL(simTime()) - inserted);
        }
    }
 
@@ -133,7 +104,7 @@ bool fifo_cache::full(){
 
 double fifo_cache::get_tc_node()
 {
-	return (double)(nodeTc/tcSamples);
+	return tc_meter.mean();
 }
 
 void fifo_cache::finish()
@@ -141,7 +112,7 @@ void fifo_cache::finish()
 	cache.clear();
 
 	base_cache::finish();
-	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
+	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << tc_meter.mean() << endl;
 }
 
 bool fifo_cache::fake_lookup(chunk_t elem){
@@ -158,7 +129,7 @@ void fifo_cache::flush()
 {
 	cache.clear();
 	actual_size=0;
-	monitored_contents.clear();
+	get_decisor()->after_flush();
 }
 
 
@@ -167,14 +138,27 @@ void fifo_cache::dump()
 	int p = 1;
 	while(deq.size()!=0)
 	{
-		cout<<p++<<" ]" << deq.front() << endl;
+		cout<<p++<<" ]" << deq.front().first << endl;
 		deq.pop_front();
 	}
 }
 
 chunk_t fifo_cache::get_toErase()
 {
-	return deq.front();
+	return deq.front().first;
+}
+
+/*
+ * 	The head of the deque is popped by the next insertion once the deque is
+ * 	full. If it holds more than one replica, the chunk stays cached (see
+ * 	data_store), but it is still the position that gets replaced.
+ */
+bool fifo_cache::eviction_candidate(chunk_t &victim)
+{
+	if (deq.empty() || deq.size() < get_size())
+		return false;
+	victim = get_toErase();
+	return true;
 }
 
 bool fifo_cache::check_if_eraseElement(chunk_t k)
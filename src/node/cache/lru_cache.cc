@@ -48,7 +48,7 @@ void lru_cache::finish()
 		Two_Lru* twoLruDecisor = (Two_Lru *) (base_cache::get_decisor());
 		if(twoLruDecisor)
 		{
-			double tcNameCache = (double)(twoLruDecisor->name_cache->nodeTc/twoLruDecisor->name_cache->tcSamples);
+			double tcNameCache = twoLruDecisor->name_cache->get_tc_node();
 			cout << "NODE # " << getParentModule()->getIndex() << " NAME CACHE Tc: " << tcNameCache << endl;
 		}
 	}*/
@@ -79,12 +79,12 @@ void lru_cache::finish()
 		}
 
 	base_cache::finish();
-	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
+	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << tc_meter.mean() << endl;
 }
 
 double lru_cache::get_tc_node()
 {
-	return (double)(nodeTc/tcSamples);
+	return tc_meter.mean();
 }
 
 /*
@@ -110,25 +110,6 @@ void lru_cache::data_store(chunk_t elem)
         actual_size++;
         lru = mru = p;
         cache[elem] = p;
-
-        // Monitoring the Tc of the first inserted content.
-    	//if(simTime() > 10*3600)
-		//{
-        if(stability)
-        {
-			map<chunk_t, double>::iterator it = monitored_contents.find(elem);
-			if(it == monitored_contents.end())
-			{
-				monitored_contents[elem] = SIMTIME_DBL(simTime());
-				//cout << "NODE # " << getParentModule()->getIndex() << " :caching content # " << elem << endl;
-			}
-			else
-			{
-				//cout << "The entry is present despite the previous miss event!\n";
-					exit(1);
-			}
-		}
-
         return;
     } 
 
@@ -148,64 +129,17 @@ void lru_cache::data_store(chunk_t elem)
         tmp->older = 0;
         tmp->newer = 0;
 
+        // Logging the Tc for the erased content, i.e., the time since its insertion or its last hit.
+        if(stability)
+        	tc_meter.sample(SIMTIME_DBL(simTime()) - SIMTIME_DBL(tmp->hit_time));
+
         free(tmp);
         cache.erase(k); 		// Drop the old LRU.
-
-        // Logging the Tc for the erased content.
-        //if(k < 200 && SIMTIME_DBL(simTime())>118.0)
-        //{
-        	//if(k < 20 || k > 100)		// Only the 10 most popular contents are monitored so far.
-        	//if(simTime() > 10*3600)
-        	//{
-        if(stability)
-        {
-				map<chunk_t, double>::iterator it = monitored_contents.find(k);
-				if(it == monitored_contents.end())
-				{
-					//cout << simTime() << " NODE # " << getParentModule()->getIndex() << " :Cannot log Tc: entry for content # " << k << " is not present!\n";
-					//	exit(1);
-				}
-				else
-				{
-					double Tc  = SIMTIME_DBL(simTime()) - monitored_contents[k];
-					monitored_contents.erase(k);
-					//int nodeId = getParentModule()->getIndex();
-					//cout << simTime() << "\tNODE\t" << nodeId << "\tContent\t" << k << "\tTc\t" << Tc << endl;
-					nodeTc += Tc;
-					tcSamples++;
-				}
-        }
-			//}
-        //}
     }
     else		// The cache is NOT full, so just update its size.
     	actual_size++;
 
     cache[elem] = p; 		// Store the new object with its position inside the map.
-
-	// Inserting a new entry to monitor the Tc. A miss event means that the content has been previously
-	// evicted, so there should be no correspondent entry inside the map.
-    //if(elem < 200 && SIMTIME_DBL(simTime())>118.0)
-    //{
-    	//if(elem < 20 || elem > 100)		// Only the 10 most popular contents are monitored so far.
-    	//if(simTime() > 10*3600)
-		//{
-    if(stability)
-    {
-			map<chunk_t, double>::iterator it = monitored_contents.find(elem);
-			if(it == monitored_contents.end())
-			{
-				monitored_contents[elem] = SIMTIME_DBL(simTime());
-				//cout << "NODE # " << getParentModule()->getIndex() << " :caching content # " << elem << endl;
-			}
-			else
-			{
-				//cout << "The entry is present despite the previous miss event!\n";
-					exit(1);
-			}
-    }
-		//}
-    //}
 }
 
 lru_pos* lru_cache::get_mru(){
@@ -224,10 +158,23 @@ lru_pos* lru_cache::get_lru(){
 	return lru;
 }
 
-const lru_pos* lru_cache::get_eviction_candidate(){
-	if ( full() ) 
-		return get_lru();
-	else return NULL;
+bool lru_cache::eviction_candidate(chunk_t &victim){
+	if ( !full() || lru == NULL )
+		return false;
+	victim = lru->k;
+	return true;
+}
+
+// The victim and the last stored chunk (the LRU and the MRU) are found without a lookup.
+double *lru_cache::cost_slot(chunk_t elem){
+	if (actual_size == 0)
+		return NULL;
+	if (mru->k == elem)
+		return &mru->cost;
+	if (lru->k == elem)
+		return &lru->cost;
+	unordered_map<chunk_t, lru_pos*>::iterator it = cache.find(elem);
+	return it == cache.end() ? NULL : &it->second->cost;
 }
 
 bool lru_cache::fake_lookup(chunk_t elem){
@@ -258,8 +205,9 @@ bool lru_cache::data_lookup(chunk_t elem)
     	pos_elem->newer->older = pos_elem->older;
         pos_elem->older->newer = pos_elem->newer;
     }
-    else if (!pos_elem->newer)		// The element is already the MRU. Do nothing.
+    else if (!pos_elem->newer)		// The element is already the MRU. Only restart its Tc timer.
     {
+        pos_elem->hit_time = simTime();
         return true;
     }
     else		// The element is the LRU. Remove it from the bottom of the list.
@@ -273,30 +221,10 @@ bool lru_cache::data_lookup(chunk_t elem)
     pos_elem->newer = 0;
     mru->newer = pos_elem;
 
-    //	Update the MRU.
+    //	Update the MRU (the hit time also restarts the Tc timer of the element).
     mru = pos_elem;
     mru->hit_time = simTime();
 
-	// Updating the Tc timer after a hit.
-    //if(elem < 200 && SIMTIME_DBL(simTime())>118.0)
-    //{
-    	//if(elem < 20 || elem > 100)		// Only the 10 most popular contents are monitored so far.
-    	//if(simTime() > 10*3600)
-		//{
-    if(stability)
-    {
-			map<chunk_t, double>::iterator itHit = monitored_contents.find(elem);
-			if(itHit == monitored_contents.end())
-			{
-				//cout << "Trying to update a non existing entry!\n";
-				//exit(1);
-			}
-			monitored_contents[elem] = SIMTIME_DBL(simTime());
-			//cout << "NODE # " << getParentModule()->getIndex() << " :hit on content # " << elem << endl;
-    }
-		//}
-    //}
-
     return true;
 }
 
@@ -314,7 +242,7 @@ void lru_cache::flush()
 {
 	cache.clear();
 	actual_size=0;
-	monitored_contents.clear();
+	get_decisor()->after_flush();
 }
 
 bool lru_cache::full()
@@ -35,13 +35,16 @@ Register_Class (random_cache);
 
 void random_cache::initialize(){
     base_cache::initialize();
+    rng = ccn_rng(this, 0);
+    next_victim = -1;
 }
 
 void random_cache::data_store(chunk_t chunk){
     cache[chunk] = true;
     if (deq.size() == get_size() ){
-        //Replacing a random element
-        unsigned int pos = intrand(  deq.size() );
+        //Replacing a random element (the one announced by eviction_candidate, if any)
+        unsigned int pos = next_victim >= 0 ? next_victim : rng.intrand( deq.size() );
+        next_victim = -1;
         chunk_t toErase = deq.at(pos);
 
         deq.at(pos) = chunk;
@@ -63,6 +66,19 @@ bool random_cache::full(){
     return (deq.size()==get_size());
 }
 
+/*
+ * 	The replaced position is drawn here and kept until the next data_store, so
+ * 	that the announced victim is the one actually evicted.
+ */
+bool random_cache::eviction_candidate(chunk_t &victim){
+    if ( deq.empty() || deq.size() < get_size() )
+	return false;
+    if ( next_victim < 0 || next_victim >= (int) deq.size() )
+	next_victim = rng.intrand( deq.size() );
+    victim = deq.at(next_victim);
+    return true;
+}
+
 /*Deprecated: used in order to fill up caches with random chunks*/
 bool random_cache::warmup(){
     int C = get_size();
@@ -0,0 +1,117 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "request_log.h"
+#include <sstream>
+#include <cstring>
+
+using namespace std;
+
+request_log::request_log():out(NULL)
+{
+	memset(&header, 0, sizeof(header));
+}
+
+request_log::~request_log()
+{
+	close();
+}
+
+/*
+ * 	Create the log and write a provisional header (counters are set by close).
+ *
+ * 	Parameters:
+ * 		- file_name: binary log.
+ * 		- node, cache_size: index and size of the logged cache.
+ * 		- error: reason of the failure (if false is returned).
+ */
+bool request_log::open(const char *file_name, uint32_t node, uint32_t cache_size, string &error)
+{
+	close();
+
+	out = fopen(file_name, "wb");
+	if (out == NULL)
+	{
+		stringstream msg;
+		msg << "Impossible to create the request log " << file_name;
+		error = msg.str();
+		return false;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, REQUEST_LOG_MAGIC, sizeof(header.magic));
+	header.version = REQUEST_LOG_VERSION;
+	header.node = node;
+	header.cache_size = cache_size;
+	header.record_size = sizeof(uint64_t);
+	buffer.reserve(BUFFER_RECORDS);
+
+	if (fwrite(&header, sizeof(header), 1, out) != 1)
+	{
+		stringstream msg;
+		msg << "Error while writing the request log " << file_name;
+		error = msg.str();
+		fclose(out);
+		out = NULL;
+		return false;
+	}
+	return true;
+}
+
+void request_log::flush()
+{
+	if (out != NULL && !buffer.empty())
+	{
+		header.num_records += fwrite(&buffer[0], sizeof(uint64_t), buffer.size(), out);
+		buffer.clear();
+	}
+}
+
+/*
+ * 	Write the pending records and the final header. Returns false if some record
+ * 	could not be written (the header accounts only for the written ones).
+ */
+bool request_log::close()
+{
+	if (out == NULL)
+		return true;
+
+	uint64_t expected = header.num_records + buffer.size();
+	flush();
+	if (header.warmup_records > header.num_records)
+		header.warmup_records = header.num_records;
+
+	bool ok = (header.num_records == expected);
+	ok = (fseek(out, 0, SEEK_SET) == 0) && ok;
+	ok = (fwrite(&header, sizeof(header), 1, out) == 1) && ok;
+	ok = (fclose(out) == 0) && ok;
+	out = NULL;
+	return ok;
+}
@@ -34,6 +34,7 @@
 #include "statistics.h"
 
 #include "error_handling.h"
+#include "results_sink.h"
 
 Register_Class(ttl_cache);
 
@@ -57,11 +58,21 @@ void ttl_cache::initialize()
     target_cache = cache_size * (1./down);
     //cout << "*** TARGET CACHE: " << target_cache << endl;
     cout << "\t TARGET CACHE: " << target_cache << endl;
-    avg_as_prev = 0.0;
     time_extend = SIMTIME_DBL(simTime());
-    cycle_avg_meas_time = SIMTIME_DBL(simTime()) - time_extend;
+    occ_last = win_start = time_extend;
 
-   	//cout << "*** AVG MEAS TIME: " << cycle_avg_meas_time << endl;
+    // Tc correction: once per simulation cycle (extend_sim), or continuously with the adaptive controller.
+    string tc_control = par("tc_control").stdstringValue();
+    if (tc_control.compare("adaptive") == 0)
+    	adaptive_tc = true;
+    else if (tc_control.compare("cycles") != 0)
+    {
+    	std::stringstream ermsg;
+    	ermsg<<"tc_control must be either \"cycles\" or \"adaptive\". Please check.";
+    	severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+    }
+    tc_tolerance = par("tc_tolerance");
+    certify_windows = par("tc_certify_windows");
 
     // TTL cache check initialization
     //ttl_check_timer = 0.2*tc_node; // Timer set to 20% of TC
@@ -116,6 +127,7 @@ void ttl_cache::handleMessage(cMessage *in)
 		switch(in->getKind())
 		{
 		case TTL_CHECK:
+			occupancy_change();
 			for (unordered_map<chunk_t,simtime_t>::iterator it = cache.begin();it != cache.end();)
 			{
 				if ( simTime() > it->second)  // The TTL of the selected content is expired
@@ -128,6 +140,9 @@ void ttl_cache::handleMessage(cMessage *in)
 					it++;
 				}
 			}
+			if(adaptive_tc)
+				control_tc();
+			avg_as_curr = (occupancy_integral() - cycle_integral) / max(SIMTIME_DBL(simTime()) - time_extend, 1e-9);
 			scheduleAt( simTime() + ttl_check_timer, ttl_check_msg );  // Schedule the next check
 			//cout << simTime() << "\tTTL CHECK\tEXIT" << endl;
 			break;
@@ -138,6 +153,7 @@ void ttl_cache::handleMessage(cMessage *in)
 			// Check the name cache
 			twoTTLDecisor->check_name_cache();
 			// Check the main cache
+			occupancy_change();
 			for (unordered_map<chunk_t,simtime_t>::iterator it = cache.begin();it != cache.end();)
 			{
 				if ( simTime() > it->second)  // The TTL of the selected content is expired
@@ -150,6 +166,9 @@ void ttl_cache::handleMessage(cMessage *in)
 					it++;
 				}
 			}
+			if(adaptive_tc)
+				control_tc();
+			avg_as_curr = (occupancy_integral() - cycle_integral) / max(SIMTIME_DBL(simTime()) - time_extend, 1e-9);
 			scheduleAt( simTime() + ttl_check_timer, ttl_check_msg );  // Schedule the next check
 			//cout << simTime() << "\tTTL CHECK\tEXIT" << endl;
 			break;
@@ -168,6 +187,11 @@ void ttl_cache::finish()
 	cout << "NODE # " << getIndex() << " MAIN CACHE ONLINE AVG ACTUAL SIZE: " << avg_as_curr << endl;
 	cout << "NODE # " << getIndex() << " MAIN MAX CACHE SIZE: " << max_as << endl;
 	cout << "NODE # " << getIndex() << " MAIN CACHE Tc: " << tc_node << endl;
+	if(adaptive_tc)
+	{
+		record_result(this, "node", getIndex(), "tc_certified", tc_certified);
+		record_result(this, "node", getIndex(), "tc_corrections", ctrl_steps);
+	}
 
 	string decision_policy = getAncestorPar("DS");
 
@@ -190,6 +214,7 @@ void ttl_cache::data_store(chunk_t elem)
 
 	cache[elem] = simTime() + tc_node; 		// Store the new object;
 	//cout << "CACHE ENTRY SIZE: " << sizeof(cache[elem]) << " Bytes" << endl;
+	occupancy_change();
 	actual_size++;
 	if(actual_size > max_as)
 		max_as = actual_size;
@@ -219,25 +244,6 @@ bool ttl_cache::data_lookup(chunk_t elem)
     if (it==cache.end())	// The content object is not present inside the cache.
     {
     	//cout << simTime() << "\tMISS\tActual Cache Size:\t" << actual_size << endl;
-
-		num_event_online_avg++;
-		//if (num_event_online_avg == max_num_event_online_avg)
-		if (dblrand() < 0.1)
-		{
-			cycle_curr_time = SIMTIME_DBL(simTime()) - time_extend;
-
-			//avg_as_curr = (double)((avg_as_prev*avg_meas_time + actual_size*(SIMTIME_DBL(simTime())-avg_meas_time))*(1./SIMTIME_DBL(simTime())));
-			avg_as_curr = (double)((avg_as_prev*cycle_avg_meas_time + actual_size*(cycle_curr_time-cycle_avg_meas_time))*(1./cycle_curr_time));
-
-			//cout << simTime() << "\tNODE: " << getIndex() << "\n\tACTUAL: " << actual_size << "\n\tMEAN PREV: " << avg_as_prev << "\n\tMEAN CURR: " << avg_as_curr << "\n\tTIME PREV: " << cycle_avg_meas_time << "\n\tTIME CURR: " << cycle_curr_time  << endl;
-
-			//if(abs(avg_as_curr - avg_as_prev)/avg_as_prev < 0.001)
-			//	conv_online_avg = true;
-
-			avg_as_prev = avg_as_curr;
-			cycle_avg_meas_time = SIMTIME_DBL(simTime()) - time_extend;
-			num_event_online_avg = 0;
-		}
     	return false;
     }
 
@@ -245,6 +251,7 @@ bool ttl_cache::data_lookup(chunk_t elem)
 
     if(simTime() > evict_time)   // MIISS
     {
+    	occupancy_change();
     	cache.erase(elem);
     	if(actual_size > 0)
     		actual_size--;
@@ -263,8 +270,10 @@ bool ttl_cache::data_lookup(chunk_t elem)
 
 void ttl_cache::flush()
 {
+	occupancy_change();
 	cache.clear();
 	actual_size=0;
+	get_decisor()->after_flush();
 }
 
 bool ttl_cache::full()
@@ -272,17 +281,93 @@ bool ttl_cache::full()
     return false;
 }
 
+/*
+ * 	Correct the Tc at the end of a simulation cycle that failed the consistency check.
+ *
+ * 	With tc_control = "cycles", Tc is scaled by target_cache/avg_as_curr and the cache is flushed, so that
+ * 	the next cycle restarts from an empty cache. With the adaptive controller, Tc is already being corrected
+ * 	continuously: the certificate is revoked (if the node still needs a correction) and the averaging cycle
+ * 	restarts, without flushing the cache.
+ */
 void ttl_cache::extend_sim()
 {
+	double now = SIMTIME_DBL(simTime());
+	if(adaptive_tc)
+	{
+		if(change_tc)
+		{
+			tc_certified = false;
+			ctrl_ok = 0;
+			win_start = now;
+			win_integral = occupancy_integral();
+		}
+		time_extend = now;
+		cycle_integral = occupancy_integral();
+		change_tc = true;
+		return;
+	}
+
 	if(change_tc)
 		tc_node = tc_node + tc_node*(target_cache*(1./avg_as_curr) - 1);
-	//avg_as_prev = target_cache;            		// Target size is used as initial value.
-	//avg_meas_time = SIMTIME_DBL(simTime());
-	time_extend = SIMTIME_DBL(simTime());
-	cycle_avg_meas_time =  SIMTIME_DBL(simTime()) - time_extend;
-
-	avg_as_prev = 0.0;
-	num_event_online_avg = 0;
 	flush();
+	time_extend = now;
+	cycle_integral = occupancy_integral();
 	change_tc = true;
 }
+
+/*
+ * 	Accumulate the occupancy integral up to the current time. It must be called before any change
+ * 	of actual_size, so that the integral is exact (and not sampled).
+ */
+void ttl_cache::occupancy_change()
+{
+	double now = SIMTIME_DBL(simTime());
+	occ_integral += actual_size * (now - occ_last);
+	occ_last = now;
+}
+
+double ttl_cache::occupancy_integral()
+{
+	return occ_integral + actual_size * (SIMTIME_DBL(simTime()) - occ_last);
+}
+
+/*
+ * 	Adaptive Tc controller (stochastic approximation on log(Tc)).
+ *
+ * 	Each measurement window lasts (at least) the current Tc, i.e., the time needed by the cache to reflect
+ * 	it. At the end of a window, log(Tc) is corrected by a_k*log(target_cache/occupancy), with steps
+ * 	a_k = (k+1)^-0.6 (the first correction is the full multiplicative one of extend_sim, later ones average
+ * 	out the measurement noise). Once the occupancy is within tc_tolerance of the target for certify_windows
+ * 	consecutive windows, Tc is frozen (convergence certificate) and the averaging cycle restarts, so that
+ * 	the consistency check of the statistics module only sees the converged Tc.
+ */
+void ttl_cache::control_tc()
+{
+	double now = SIMTIME_DBL(simTime());
+	if(tc_certified || now - win_start < max(tc_node, SIMTIME_DBL(ttl_check_timer)))
+		return;
+
+	double occupancy = (occupancy_integral() - win_integral) / (now - win_start);
+	if(abs(occupancy - target_cache) / target_cache < tc_tolerance)
+		ctrl_ok++;
+	else
+		ctrl_ok = 0;
+
+	if(ctrl_ok >= certify_windows)
+	{
+		tc_certified = true;
+		time_extend = now;
+		cycle_integral = occupancy_integral();
+		cout << "NODE # " << getIndex() << " Tc CERTIFIED at " << now << " - Tc: " << tc_node << " Occupancy: " << occupancy
+			 << " Target: " << target_cache << " Corrections: " << ctrl_steps << endl;
+		return;
+	}
+
+	// An empty window (no insertions) doubles Tc.
+	double err = (occupancy > 0) ? log(target_cache / occupancy) : log(2.);
+	tc_node *= exp(err / pow(ctrl_steps + 1, 0.6));
+	ctrl_steps++;
+
+	win_start = now;
+	win_integral = occupancy_integral();
+}
@@ -43,6 +43,7 @@
 #include "two_ttl_policy.h"
 
 #include "error_handling.h"
+#include "results_sink.h"
 
 Register_Class(core_layer);
 int core_layer::repo_interest = 0;
@@ -54,6 +55,7 @@ void  core_layer::initialize()
 	RTT = par("RTT");
 
 	interest_aggregation = par("interest_aggregation");
+	pit_max_range = 1;
 	transparent_to_hops = par("transparent_to_hops");
 
 	repo_load = 0;
@@ -89,6 +91,44 @@ void  core_layer::initialize()
 
 	clear_stat();
 
+	// *** Fluid fast path ***
+	fluid = par("fluid");
+	fluid_seq = 0;
+	fluid_timer = new cMessage("fluid_delivery", FLUID_DELIVERY);
+	if (fluid)
+		setup_fluid_links();
+
+	// *** Face shaping ***
+	datarate = par("datarate");
+	shaping = par("shaping");
+	if (shaping)
+		setup_face_queues();
+
+	// *** PIT lifetime and capacity ***
+	pit_lifetime = par("pit_lifetime");
+	int capacity = par("max_pit");
+	string pit_full = par("pit_full").stdstringValue();
+	if (pit_lifetime < 0 || capacity < 0 || (pit_full != "drop" && pit_full != "evict_oldest"))
+	{
+		std::stringstream msg;
+		msg<<"pit_lifetime="<<pit_lifetime<<", max_pit="<<capacity<<", pit_full="<<pit_full<<
+			" are not valid: pit_lifetime and max_pit must be >= 0, pit_full drop or evict_oldest";
+		severe_error(__FILE__, __LINE__, msg.str().c_str() );
+	}
+	max_pit = capacity;
+	pit_evict_oldest = (pit_full == "evict_oldest");
+	pit_managed = (pit_lifetime > 0 || max_pit > 0);
+	pit_cursor = 0;
+	pit_records = 0;
+	if (pit_managed)
+		pit_wheel.resize(PIT_WHEEL_SLOTS);
+	if (pit_lifetime > 0)
+	{
+		pit_tick = pit_lifetime / (PIT_WHEEL_SLOTS - 2);
+		pit_check = new cMessage("pit_check", PIT_CHECK);
+		scheduleAt(simTime() + pit_tick, pit_check);
+	}
+
 	#ifdef SEVERE_DEBUG
 	check_if_correct(__LINE__);
 	is_it_initialized = true;
@@ -106,18 +146,11 @@ void  core_layer::initialize()
 	#endif
 
 	// *** Link Load Evaluation ***
-	stable = false;
 	catCard = (long)content_distribution::zipf[0]->get_catalog_card();
 	llEval = par("llEval");
 	if(llEval)
 	{
-		// *** DISABLED
-		//load_check = new cMessage("load_check", LOAD_CHECK);
-
-		
-		//batchSize = 10;    // packets (disabled if we want synchronized measure for all links)
 		maxInterval = par("maxInterval"); // seconds
-		datarate = par("datarate");
 
 		cModule* pSubModule = getParentModule()->getParentModule()->getSubmodule("statistics");
 		statistics* pClass2Module = dynamic_cast<statistics*>(pSubModule);
@@ -125,43 +158,20 @@ void  core_layer::initialize()
 
 		//simDuration = getAncestorPar("steady");
 
-		// *** DISABLED
-		//scheduleAt(simTime() + maxInterval, load_check);
-
-		int numOutInterf = gateSize("face$o") - 1;     // Interface # 0 is always connected to the client module.
-
-		// With Percentiles
-		/*percID = new unsigned int[numPercentiles+1];
-		percID[0] = 0;
-		for(int i=1; i <= numPercentiles; i++)
+		// Per-face counters (face 0, towards the client, is not measured), with the optional
+		// breakdown in llBuckets log-spaced content rank bins.
+		int llBuckets = par("llBuckets");
+		if (llBuckets < 0)
 		{
-			percID[i] = content_distribution::zipf.value(percentiles[i-1]);
-			cout << " *** ID Percentile # " << i << " = " << percID[i] << endl;
-		}*/
-
-		// With percentiles
-		//numPackets = new double*[numOutInterf];
-		numBits = new double*[numOutInterf];
-		//intvlNumPackets = new unsigned long*[numOutInterf];
-		//intvlNumBits = new unsigned long*[numOutInterf];
-
-		for(int i=0; i < numOutInterf; i++)
-		{
-			//numPackets[i] = new double[catCard];
-			//fill_n(numPackets[i], catCard, 0);
-			numBits[i] = new double[catCard];
-			fill_n(numBits[i], catCard, 0);
-			//intvlNumPackets[i] = new unsigned long[numPercentiles];
-			//fill_n(intvlNumPackets[i], numPercentiles, 0);
-			//intvlNumBits[i] = new unsigned long[numPercentiles];
-			//fill_n(intvlNumBits[i], numPercentiles, 0);
+			std::stringstream msg;
+			msg<<"llBuckets must be >= 0. Please check.";
+			severe_error(__FILE__, __LINE__, msg.str().c_str() );
 		}
+		link_loads.init(gateSize("face$o") - 1, catCard, llBuckets);
 
-		// Without percentiles
-		/*numPackets = new double[numOutInterf];
-		numBits = new double[numOutInterf];
-		intvlNumPackets = new unsigned long[numOutInterf];
-		intvlNumBits = new unsigned long[numOutInterf];*/
+		// Time series of the load of each face, sampled every maxInterval.
+		load_check = new cMessage("load_check", LOAD_CHECK);
+		scheduleAt(simTime() + maxInterval, load_check);
 	}
 }
 
@@ -218,10 +228,33 @@ void core_layer::handleMessage(cMessage *in)
 		delete in;
 		break;
 
+    case FLUID_DELIVERY:	// Deliver all the packets arrived through the fluid fast path.
+    	while (!fluid_queue.empty() && fluid_queue.top().time <= simTime())
+    	{
+    		fluid_arrival arrival = fluid_queue.top();
+    		fluid_queue.pop();
+
+    		// The packet looks as if it was received through the corresponding face.
+			#if OMNETPP_VERSION >= 0x0500
+    		arrival.msg->setArrival(getId(), arrival.gate, simTime());
+			#else
+    		arrival.msg->setArrival(this, arrival.gate, simTime());
+			#endif
+    		handleMessage(arrival.msg);
+    	}
+    	if (!fluid_queue.empty())
+    		scheduleAt(fluid_queue.top().time, fluid_timer);
+    	break;
+
     case LOAD_CHECK:
     	evaluateLinkLoad();
     	scheduleAt(simTime() + maxInterval, in);
     	break;
+
+    case PIT_CHECK:
+    	pit_expire();
+    	scheduleAt(simTime() + pit_tick, in);
+    	break;
     }
 
     //delete in;
@@ -248,26 +281,65 @@ void core_layer::finish()
 //		}
 	#endif
 
-    char name [30];
-
-    sprintf ( name, "interests[%d]", getIndex());	// Total number of received Interest packets.
-    recordScalar (name, interests);
+    record_result(this, "node", getIndex(), "interests", interests);	// Total number of received Interest packets.
 
     if (repo_load != 0)
-    {
-		sprintf ( name, "repo_load[%d]", getIndex());
-		recordScalar(name,repo_load);
-    }
+		record_result(this, "node", getIndex(), "repo_load", repo_load);
 
-    sprintf ( name, "data[%d]", getIndex());	//	Total number of received Data packets.
-    recordScalar (name, data);
+    record_result(this, "node", getIndex(), "data", data);		//	Total number of received Data packets.
 
     if (repo_interest != 0)
     {
-    	sprintf ( name, "repo_int[%d]", getIndex());	// Total number of Interest packets sent to the attached repository (if present).
-    	recordScalar(name, repo_interest);
+    	record_result(this, "node", getIndex(), "repo_int", repo_interest);	// Total number of Interest packets sent to the attached repository (if present).
     	repo_interest = 0;
     }
+
+    if (llEval)
+    	link_loads.record(this, getIndex(), SIMTIME_DBL(simTime()), datarate);	// Average load of each face after the transient.
+
+    if (shaping)
+    {
+    	unsigned long sent = 0, dropped = 0;
+    	double wait = 0;
+    	for (unsigned f = 0; f < face_queues.size(); f++)
+    	{
+    		sent += face_queues[f].sent;
+    		dropped += face_queues[f].dropped;
+    		wait += face_queues[f].wait;
+    	}
+    	record_result(this, "node", getIndex(), "queue_sent", sent);		// Packets transmitted through shaped faces.
+    	record_result(this, "node", getIndex(), "queue_drops", dropped);	// Packets dropped by full queues.
+    	record_result(this, "node", getIndex(), "queue_delay", sent ? wait / sent : 0);	// Average queueing delay [s].
+    }
+
+    if (pit_managed)
+    {
+    	record_result(this, "node", getIndex(), "pit_expired", pit_expired);	// PIT entries expired without Data.
+    	record_result(this, "node", getIndex(), "pit_evicted", pit_evicted);	// PIT entries evicted by a full PIT.
+    	record_result(this, "node", getIndex(), "pit_drops", pit_drops);		// Interests dropped by a full PIT.
+    	record_result(this, "node", getIndex(), "pit_peak", pit_peak);		// Maximum number of PIT entries.
+    }
+
+    // *** PIT aggregation statistics ***
+    pit_face_stats total = pit_face_stats();
+    for (unsigned f = 0; f < pit_faces.size(); f++)
+    {
+    	total.aggregated += pit_faces[f].aggregated;
+    	total.duplicates += pit_faces[f].duplicates;
+    	total.satisfied += pit_faces[f].satisfied;
+    	if (pit_faces[f].aggregated || pit_faces[f].duplicates || pit_faces[f].satisfied)
+    	{
+    		std::stringstream face;
+    		face << "_face" << f;
+    		record_result(this, "node", getIndex(), ("pit_agg" + face.str()).c_str(), pit_faces[f].aggregated);
+    		record_result(this, "node", getIndex(), ("pit_dup" + face.str()).c_str(), pit_faces[f].duplicates);
+    		record_result(this, "node", getIndex(), ("pit_sat" + face.str()).c_str(), pit_faces[f].satisfied);
+    	}
+    }
+    record_result(this, "node", getIndex(), "pit_aggregated", total.aggregated);		// Interests aggregated (not forwarded upstream).
+    record_result(this, "node", getIndex(), "pit_duplicates", total.duplicates);		// Interests suppressed by their nonce.
+    record_result(this, "node", getIndex(), "pit_saved_chunks", pit_saved_chunks);	// Chunks not requested upstream thanks to aggregation.
+    record_result(this, "node", getIndex(), "pit_fanout", pit_satisfied ? total.satisfied * 1. / pit_satisfied : 0);	// Faces served per satisfied PIT entry.
 }
 
 
@@ -293,7 +365,6 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 	#endif
 
 	chunk_t chunk = int_msg->getChunk();
-    double int_btw = int_msg->getBtw();
 
     bool cacheable = true;  // This value indicates whether the retrieved content will be cached.
     						// Usually it is always true, and it can be changed only with 2-LRU meta-caching.
@@ -319,7 +390,46 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 
     //cout << "** Receiver INTEREST for content: " << int_msg->get_name() << " **" << endl;
 
-    if (ContentStore->lookup(chunk))	// a) Lookup inside the local Content Store.
+    int range = int_msg->getRange();
+    if (range > 1)
+    {
+    	// Segment train: the chunks of the train are looked up one by one (so hit/miss statistics
+    	// are per chunk) and the train is split into maximal runs of cached/non-cached chunks.
+    	// Each run is then served as a shorter train by reusing the same Interest.
+    	uint64_t hits = ContentStore->lookup_train(chunk, range);
+    	int start = 0;
+    	for (int k = 1; k <= range; k++)
+    	{
+    		if (k == range || ((hits >> k) & 1) != ((hits >> start) & 1))
+    		{
+    			int_msg->setChunk(nth_chunk(chunk, start));
+    			int_msg->setRange(k - start);
+    			serve_interest(int_msg, cacheable, (hits >> start) & 1);
+    			start = k;
+    		}
+    	}
+    }
+    else
+    	serve_interest(int_msg, cacheable, ContentStore->lookup(chunk));
+}
+
+
+/*
+ * Serves an Interest whose chunks have already been looked up inside the Content Store.
+ * In case of a segment train, all the chunks of the Interest are either cached or not.
+ *
+ * Parameters:
+ * 	- int_msg: Interest (or run of a segment train) to be served.
+ * 	- cacheable: whether the retrieved content will be cached (only with 2-LRU and 2-TTL meta-caching).
+ * 	- hit: whether the requested chunks are inside the local Content Store.
+ */
+void core_layer::serve_interest(ccn_interest *int_msg, bool cacheable, bool hit)
+{
+	chunk_t chunk = int_msg->getChunk();
+	int range = int_msg->getRange();
+    double int_btw = int_msg->getBtw();
+
+    if (hit)	// a) Lookup inside the local Content Store.
     {
     	// *** Logging HIT EVENT with timestamp
     	//
@@ -329,6 +439,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
     	// The received Interest is satisfied locally.
         ccn_data* data_msg = compose_data(chunk);
 
+        data_msg->setRange(range);
         data_msg->setHops(0);
         data_msg->setBtw(int_btw);
         data_msg->setTarget(getIndex());
@@ -342,66 +453,8 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 
         
         // *** Link Load Evaluation ***
-		if(llEval && stable)
-		{
-			if(!(ContentStore->__check_client(int_msg->getArrivalGate()->getIndex())))
-			{
-				int outIndex = int_msg->getArrivalGate()->getIndex() - 1; // Because we downsized the vectors for the load evaluation
-																		  // by excluding the face towards the client.
-				// With percentiles
-				//for(int i=1; i <= numPercentiles+1; i++)
-				//{
-					// Complete (put attention on the first interval)
-				//	if(__id(chunk) > percID[i-1] && __id(chunk)<= percID[i])
-				//	{
-						// cout << "NODE # " << getIndex() << " - TX - Content # " << __id(chunk) << " from Interface N " << outIndex << " between percentiles " << percID[i-1] << " and " << percID[i] << endl;
-						// Only sent DATA packets are considered (supposed having a size of 1536 Bytes)
-						// With percentiles
-						//numPackets[outIndex][i-1]++;
-						//numBits += ((cPacket*)msg)->getBitLength();
-						//numBits[outIndex][i-1] += 1536*8;
-						// Without percentiles
-						//numPackets[outIndex]++;
-						numBits[outIndex][__id(chunk)-1] += 1536*8;
-
-						// LOG Link Load in time
-						if(getIndex() == 0)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 1)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-						else if(getIndex() == 1)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 3)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-						else if(getIndex() == 3)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 7)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-						// With percentiles
-						//intvlNumPackets[outIndex][i-1]++;
-						//intvlNumBits += ((cPacket*)msg)->getBitLength();
-						//intvlNumBits[outIndex][i-1] += 1536*8;
-						//break;
-
-						// Without percentiles
-						//intvlNumPackets[outIndex]++;
-						//intvlNumBits[outIndex] += 1536*8;
-				//	}
-				//}
-			}
-		}
+		if(llEval && !ContentStore->__check_client(int_msg->getArrivalGate()->getIndex()))
+			link_loads.account(int_msg->getArrivalGate()->getIndex() - 1, __id(chunk), range);	// Face 0 (client) is not measured.
 
         #ifdef SEVERE_DEBUG
         interests_satisfied_by_cache++;
@@ -417,10 +470,11 @@ void core_layer::handle_interest(ccn_interest *int_msg)
     	// We are mimicking an Interest sent to the repository.
         ccn_data* data_msg = compose_data(chunk);
 	
+		data_msg->setRange(range);
 		data_msg->setPrice(repo_price); 	// I fix in the data msg the cost of the object
 											// that is the price of the repository
-		repo_interest++;
-		repo_load++;
+		repo_interest += range;
+		repo_load += range;
 
         data_msg->setHops(1);
         data_msg->setTarget(getIndex());
@@ -440,67 +494,8 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 		send_data(data_msg,"face$o",int_msg->getArrivalGate()->getIndex(),__LINE__);
 
         // *** Link Load Evaluation ***
-		if(llEval && stable)
-		{
-			if(!(ContentStore->__check_client(int_msg->getArrivalGate()->getIndex())))
-			{
-				int outIndex = int_msg->getArrivalGate()->getIndex() - 1; // Because we downsized the vectors for the load evaluation
-																		  // by excluding the face towards the client.
-				// With percentiles
-				//for(int i=1; i <= numPercentiles+1; i++)
-				//{
-					// Complete (put attention on the first interval)
-					//if(__id(chunk) > percID[i-1] && __id(chunk)<= percID[i])
-					//{
-						//cout << "NODE # " << getIndex() << " - TX - Content # " << __id(chunk) << " from Interface N " << outIndex << " between percentiles " << percID[i-1] << " and " << percID[i] << endl;
-						// Only sent DATA packets are considered (supposed having a size of 1536 Bytes)
-						// With percentiles
-//						numPackets[outIndex][i-1]++;
-//						//numBits += ((cPacket*)msg)->getBitLength();
-//						numBits[outIndex][i-1] += 1536*8;
-//
-//						intvlNumPackets[outIndex][i-1]++;
-//						//intvlNumBits += ((cPacket*)msg)->getBitLength();
-//						intvlNumBits[outIndex][i-1] += 1536*8;
-//						break;
-
-						// Without percentiles
-						//numPackets[outIndex]++;
-						//numBits += ((cPacket*)msg)->getBitLength();
-						numBits[outIndex][__id(chunk)-1] += 1536*8;
-
-						// LOG Link Load in time
-						if(getIndex() == 0)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 1)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-						else if(getIndex() == 1)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 3)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-						else if(getIndex() == 3)
-						{
-							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 7)
-							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-							}
-						}
-
-						//intvlNumPackets[outIndex]++;
-						//intvlNumBits[outIndex] += 1536*8;
-					//}
-				//}
-			}
-		}
+		if(llEval && !ContentStore->__check_client(int_msg->getArrivalGate()->getIndex()))
+			link_loads.account(int_msg->getArrivalGate()->getIndex() - 1, __id(chunk), range);	// Face 0 (client) is not measured.
 
 
 		#ifdef SEVERE_DEBUG
@@ -535,11 +530,18 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 			|| simTime() - PIT[chunk].time > 2*RTT
         )
         {
+			if (pitIt==PIT.end() && !pit_admit())
+				return;							// The PIT is full: the Interest is dropped.
+
 			i_will_forward_interest = true;
 			if (pitIt!=PIT.end())				// Invalidate and re-create a new PIT entry.
 				PIT.erase(chunk);
 
 			PIT[chunk].time = simTime();
+			PIT[chunk].range = range;
+			PIT[chunk].pending = train_mask(0, range);
+			PIT[chunk].n_nonces = 0;
+			pit_track(chunk);
 
 	    	if(!cacheable)						// Set the cacheable flag inside the PIT entry.
 	    		PIT[chunk].cacheable.reset();
@@ -547,6 +549,27 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 	    		PIT[chunk].cacheable.set();
 		}
 
+		// Copy of an Interest already in the PIT entry (e.g., a loop or a parallel path): suppressed.
+		int face = int_msg->getArrivalGate()->getIndex();
+		pit_entry &entry = PIT[chunk];
+		if (!entry.add_nonce(int_msg->getNonce()))
+		{
+			pit_faces[face].duplicates++;
+			return;
+		}
+
+		// The pending entry does not cover the whole train (a longer train, or chunks already
+		// received through a shorter run): the Interest is forwarded anyway.
+		uint64_t requested = train_mask(0, range);
+		if ((entry.pending & requested) != requested)
+		{
+			i_will_forward_interest = true;
+			entry.pending |= requested;
+			entry.range = std::max(entry.range, range);
+		}
+		if (range > pit_max_range)
+			pit_max_range = range;
+
 		if (int_msg->getTarget() == getIndex() )
 		{	// I am the target of this interest but I have no more the object
 			// Therefore, this interest cannot be aggregated with the others
@@ -557,9 +580,14 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 			i_will_forward_interest = true;
 
 		if (i_will_forward_interest)
-		{  	bool * decision = strategy->get_decision(int_msg);
+		{  	interface_t decision = strategy->get_decision(int_msg);
 	    	handle_decision(decision,int_msg);
-	    	delete [] decision;//free memory for the decision array
+	    	pit_forwarded++;
+		}
+		else
+		{	// Aggregated: neither the Interest nor its Data cross the upstream links.
+			pit_faces[face].aggregated++;
+			pit_saved_chunks += int_msg->getRange();
 		}
 
 		#ifdef SEVERE_DEBUG
@@ -599,90 +627,63 @@ void core_layer::handle_data(ccn_data *data_msg)
     int i = 0;
     interface_t interfaces = 0;
     chunk_t chunk = data_msg -> getChunk();
-
-    unordered_map < chunk_t , pit_entry >::iterator pitIt = PIT.find(chunk);
+    int range = data_msg -> getRange();		// Number of chunks carried (segment train).
 
 	#ifdef SEVERE_DEBUG
 		int copies_sent = 0;
 	#endif
 
-    if ( pitIt != PIT.end() )		// A PIT entry is found.
+	// PIT entries waiting for some of the carried chunks. Trains split upstream come back as
+	// several Data, each one satisfying part of the entry keyed by the train start (up to
+	// pit_max_range-1 chunks before); entries of trains starting inside the range may also wait.
+	bool found = false;
+	bool cacheable = false;
+	cnumber_t number = __chunk(chunk);
+	int first = - (int) std::min<cnumber_t>(number, pit_max_range - 1);
+	for (int k = first; k < range; k++)
 	{
+		unordered_map < chunk_t , pit_entry >::iterator pitIt = PIT.find(nth_chunk(chunk, k));
+		if (pitIt == PIT.end())
+			continue;
+
+		// Chunks of the entry carried by the Data.
+		uint64_t carried = (k < 0) ? train_mask(-k, range) : train_mask(0, range - k);
+		if (!(pitIt->second.pending & carried))
+			continue;
+
+		if (!found)
+			// The PIT entry is created when the Interest is forwarded: its age is the RTT through the face.
+			strategy->interest_satisfied(chunk, data_msg->getArrivalGate()->getIndex(),
+					SIMTIME_DBL(simTime()) - SIMTIME_DBL(pitIt->second.time));
+		found = true;
+		cacheable = cacheable || pitIt->second.cacheable.test(0);
+		interfaces |= pitIt->second.interfaces;
+
+		pitIt->second.pending &= ~carried;
+		if (!pitIt->second.pending)		// The whole train has been received.
+			PIT.erase(pitIt);
+	}
 
-    	if (pitIt->second.cacheable.test(0))  // Cache the content only if the cacheable bit is set.
+    if ( found )		// At least a PIT entry is found.
+	{
+    	if (cacheable)  // Cache the content only if the cacheable bit is set.
     		ContentStore->store(data_msg);
 		else
-			ContentStore->after_discarding_data();
+			for (int k = 0; k < range; k++)
+				ContentStore->after_discarding_data();
 
-    	interfaces = (pitIt->second).interfaces;	// Get incoming interfaces.
+		pit_satisfied++;
 		i = 0;
 		while (interfaces)
 		{
 			if ( interfaces & 1 )
 			{
 				send_data(data_msg->dup(), "face$o", i,__LINE__ );
+				pit_faces[i].satisfied++;
 
 		        // *** Link Load Evaluation ***
-				if(llEval && stable)
-				{
-					if(!(ContentStore->__check_client(i)))
-					{
-						int outIndex = i - 1; // Because we downsized the vectors for the load evaluation
-																				  // by excluding the face towards the client.
-					//	for(int i=1; i <= numPercentiles+1; i++)
-					//	{
-							// Complete (put attention on the first interval)
-					//		if(chunk > percID[i-1] && chunk <= percID[i])
-					//		{
-								//cout << "NODE # " << getIndex() << " - TX - Content # " << __id(chunk) << " from Interface N " << outIndex << " between percentiles " << percID[i-1] << " and " << percID[i] << endl;
-								// Only sent DATA packets are considered (supposed having a size of 1536 Bytes)
-//								numPackets[outIndex][i-1]++;
-//								//numBits += ((cPacket*)msg)->getBitLength();
-//								numBits[outIndex][i-1] += 1536*8;
-//
-//								intvlNumPackets[outIndex][i-1]++;
-//								//intvlNumBits += ((cPacket*)msg)->getBitLength();
-//								intvlNumBits[outIndex][i-1] += 1536*8;
-//								break;
-
-								// Without percentiles
-								//numPackets[outIndex]++;
-								//numBits += ((cPacket*)msg)->getBitLength();
-								numBits[outIndex][__id(chunk)-1] += 1536*8;
-
-								// LOG Link Load in time
-								if(getIndex() == 0)
-								{
-									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-									if(nextNode == 1)
-									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-									}
-								}
-								else if(getIndex() == 1)
-								{
-									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-									if(nextNode == 3)
-									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-									}
-								}
-								else if(getIndex() == 3)
-								{
-									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
-									if(nextNode == 7)
-									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
-									}
-								}
-
-								//intvlNumPackets[outIndex]++;
-								//intvlNumBits[outIndex] += 1536*8;
-
-					//		}
-					//	}
-					}
-				}
+				if(llEval && !ContentStore->__check_client(i))
+					link_loads.account(i - 1, __id(chunk), range);	// Face 0 (client) is not measured.
 
 
 				#ifdef SEVERE_DEBUG
@@ -699,15 +700,13 @@ void core_layer::handle_data(ccn_data *data_msg)
 		else unsolicited_data++;
 	#endif
 
-    PIT.erase(chunk); //erase pending PIT entry.
-
     #ifdef SEVERE_DEBUG
 	check_if_correct(__LINE__);
 	#endif
 }
 
 
-void core_layer::handle_decision(bool* decision,ccn_interest *interest){
+void core_layer::handle_decision(interface_t decision,ccn_interest *interest){
 
 	#ifdef SEVERE_DEBUG
 	bool interest_has_been_forwarded = false;
@@ -719,7 +718,7 @@ void core_layer::handle_decision(bool* decision,ccn_interest *interest){
     for (int i = 0; i < __get_outer_interfaces(); i++)
 	{
 		#ifdef SEVERE_DEBUG
-			if (decision[i] == true && __check_client(i) )
+			if (__face(decision, i) && __check_client(i) )
 			{
 				std::stringstream msg; 
 				msg<<"I am node "<< getIndex()<<" and the interface supposed to give"<<
@@ -731,9 +730,17 @@ void core_layer::handle_decision(bool* decision,ccn_interest *interest){
 			}
 		#endif
 
-		if (decision[i] == true && !__check_client(i))
+		if (__face(decision, i) && !__check_client(i))
 		{
-			sendDelayed(interest->dup(),interest->getDelay(),"face$o",i);
+			simtime_t delay = 0;
+			if (shaping && !face_enqueue(i, face_queue::INTEREST_BITS, delay))
+				continue;		// Dropped by the queue of the face.
+			delay += interest->getDelay();
+
+			if (fluid_reachable(i))
+				fluid_send(interest->dup(), i, delay);
+			else
+				sendDelayed(interest->dup(),delay,"face$o",i);
 			#ifdef SEVERE_DEBUG
 			interest_has_been_forwarded = true;
 			#endif
@@ -749,7 +756,7 @@ void core_layer::handle_decision(bool* decision,ccn_interest *interest){
 
 			for (int i = 0; i < __get_outer_interfaces(); i++)
 			{
-				if (decision[i] == true)
+				if (__face(decision, i))
 				{
 					if ( __check_client(i) ){
 						affirmative_decision_from_client++;
@@ -765,7 +772,7 @@ void core_layer::handle_decision(bool* decision,ccn_interest *interest){
 			msg<<"I am node "<< getIndex()<<" and interest for chunk "<<
 				interest->getChunk()<<" has not been forwarded. "<<
 				". One of the possible repositories of this chunk is "<< 
-				interest->get_repos()[0] <<" and the target of the interest is "<<
+				*interest->repos().begin() <<" and the target of the interest is "<<
 				interest->getTarget() <<
 				". affirmative_decision_for_client = "<<
 				affirmative_decision_from_client<<
@@ -812,6 +819,18 @@ void core_layer::clear_stat(){
 	ContentStore->set_decision_yes(0);
 	ContentStore->set_decision_no(0);
 
+	link_loads.clear(SIMTIME_DBL(simTime()));
+	for (unsigned f = 0; f < face_queues.size(); f++)
+	{
+		face_queues[f].sent = face_queues[f].dropped = 0;
+		face_queues[f].wait = 0;
+	}
+	pit_expired = pit_evicted = pit_drops = 0;
+	pit_peak = PIT.size();
+
+	pit_faces.assign(gateSize("face$o"), pit_face_stats());
+	pit_forwarded = pit_saved_chunks = pit_satisfied = 0;
+
     
    	#ifdef SEVERE_DEBUG
 	unsolicited_data = 0;
@@ -926,6 +945,93 @@ void core_layer::add_to_pit(chunk_t chunk, int gateindex)
 	#endif
 }
 
+/*
+ * 	Keep the creation record of the PIT entry just created for 'chunk' (PIT lifetime and capacity).
+ * 	Stale records are dropped when they outnumber the entries, so that, without a lifetime,
+ * 	the wheel does not grow with the satisfied entries.
+ */
+void core_layer::pit_track(chunk_t chunk)
+{
+	if (PIT.size() > pit_peak)
+		pit_peak = PIT.size();
+	if (!pit_managed)
+		return;
+
+	pit_timer record;
+	record.chunk = chunk;
+	record.time = simTime();
+	// With a lifetime, the slot is expired after PIT_WHEEL_SLOTS-1 ticks; otherwise the wheel does not turn.
+	unsigned slot = pit_lifetime > 0 ? (pit_cursor + PIT_WHEEL_SLOTS - 1) % PIT_WHEEL_SLOTS : pit_cursor;
+	pit_wheel[slot].push_back(record);
+	pit_records++;
+
+	if (pit_records > 2 * PIT.size() + PIT_WHEEL_SLOTS)
+	{
+		pit_records = 0;
+		for (unsigned s = 0; s < PIT_WHEEL_SLOTS; s++)
+		{
+			std::deque<pit_timer> valid;
+			for (unsigned k = 0; k < pit_wheel[s].size(); k++)
+				if (pit_valid(pit_wheel[s][k]))
+					valid.push_back(pit_wheel[s][k]);
+			pit_wheel[s].swap(valid);
+			pit_records += pit_wheel[s].size();
+		}
+	}
+}
+
+bool core_layer::pit_valid(const pit_timer &record)
+{
+	unordered_map < chunk_t , pit_entry >::iterator pitIt = PIT.find(record.chunk);
+	return pitIt != PIT.end() && pitIt->second.time == record.time;
+}
+
+/*
+ * 	Room for a new PIT entry: with a full PIT (max_pit entries), either the oldest entry is
+ * 	evicted or the new entry is refused.
+ */
+bool core_layer::pit_admit()
+{
+	if (max_pit == 0 || PIT.size() < max_pit)
+		return true;
+
+	if (pit_evict_oldest)
+		for (unsigned k = 1; k <= PIT_WHEEL_SLOTS; k++)		// From the oldest slot to the newest one.
+		{
+			std::deque<pit_timer> &slot = pit_wheel[(pit_cursor + k) % PIT_WHEEL_SLOTS];
+			while (!slot.empty())
+			{
+				pit_timer record = slot.front();
+				slot.pop_front();
+				pit_records--;
+				if (pit_valid(record))
+				{
+					PIT.erase(record.chunk);
+					pit_evicted++;
+					return true;
+				}
+			}
+		}
+
+	pit_drops++;
+	return false;
+}
+
+//	Timing wheel tick: the entries of the next slot have reached their lifetime.
+void core_layer::pit_expire()
+{
+	pit_cursor = (pit_cursor + 1) % PIT_WHEEL_SLOTS;
+	std::deque<pit_timer> &slot = pit_wheel[pit_cursor];
+	for (unsigned k = 0; k < slot.size(); k++)
+		if (pit_valid(slot[k]))
+		{
+			PIT.erase(slot[k].chunk);
+			pit_expired++;
+		}
+	pit_records -= slot.size();
+	slot.clear();
+}
+
 /*
  * 	Forward a Data packet.
  */
@@ -975,75 +1081,228 @@ int	core_layer::send_data(ccn_data* msg, const char *gatename, int gateindex, in
 		}
 	}
 	#endif
+
+	simtime_t delay = 0;
+	if (shaping && !face_enqueue(gateindex, (double) link_load_monitor::DATA_BITS * msg->getRange(), delay))
+	{
+		delete msg;		// Dropped by the queue of the face.
+		return 0;
+	}
+
+	if (fluid_reachable(gateindex))
+	{
+		fluid_send(msg, gateindex, delay);
+		return 0;
+	}
+	if (delay > 0)
+		return sendDelayed (msg, delay, gatename, gateindex);
 	return send (msg, gatename, gateindex);
 }
 
-int core_layer::getOutInt(int dest)
+/*
+ * 	Fluid fast path. For each face, checks whether the link can be bypassed, i.e., whether it ends
+ * 	into the core_layer of another node and its channel only introduces a propagation delay
+ * 	(no datarate, no bit/packet errors). Faces towards clients always use the standard path.
+ */
+void core_layer::setup_fluid_links()
 {
-	return strategy->get_out_interface(dest);
+	fluid_links.assign(gateSize("face$o"), fluid_link());
+	for (int i = 0; i < gateSize("face$o"); i++)
+	{
+		fluid_link &link = fluid_links[i];
+		link.peer = NULL;
+		link.channel = NULL;
+		link.delay = 0;
+
+		bool eligible = true;
+		int channels = 0;
+		for (cGate *g = gate("face$o", i); g->getNextGate() != NULL; g = g->getNextGate())
+		{
+			cChannel *ch = g->getChannel();
+			if (ch == NULL)
+				continue;
+			channels++;
+			link.channel = ch;
+
+			if (cDatarateChannel *dch = dynamic_cast<cDatarateChannel *>(ch))
+			{
+				if (dch->getDatarate() != 0 || dch->getBitErrorRate() != 0 || dch->getPacketErrorRate() != 0)
+					eligible = false;
+				link.delay += dch->getDelay();
+			}
+			else if (cDelayChannel *dch = dynamic_cast<cDelayChannel *>(ch))
+				link.delay += dch->getDelay();
+			else if (dynamic_cast<cIdealChannel *>(ch) == NULL)
+				eligible = false;		// Unknown channel type: its behaviour cannot be reproduced.
+		}
+
+		cGate *end = gate("face$o", i)->getPathEndGate();
+		core_layer *peer = dynamic_cast<core_layer *>(end->getOwnerModule());
+		if (eligible && channels <= 1 && peer != NULL)
+		{
+			link.peer = peer;
+			link.peer_gate = end->getId();
+		}
+	}
 }
 
-void core_layer::evaluateLinkLoad()
+/*
+ * 	Face shaping. Faces towards other nodes transmit at the datarate of their channel (if it has
+ * 	one) or at the datarate parameter; faces towards clients are not shaped.
+ */
+void core_layer::setup_face_queues()
 {
-/*	double currentBitPerSec;
-	double currentChLoad;
-	//double cumSumChLoad = 0.0;
-	int nextNode;
-	if (SIMTIME_DBL(simTime()) + maxInterval >= simDuration)  // Print average statistics
+	int queue_limit = par("queue_limit");
+	if (datarate <= 0 || queue_limit < 0)
 	{
-		for(int i=0; i < gateSize("face$o") - 1; i++)
+		std::stringstream msg;
+		msg<<"With shaping, datarate must be > 0 and queue_limit >= 0. Please check.";
+		severe_error(__FILE__, __LINE__, msg.str().c_str() );
+	}
+
+	face_queues.assign(gateSize("face$o"), face_queue());
+	for (int i = 0; i < gateSize("face$o"); i++)
+	{
+		face_queue &q = face_queues[i];
+		q.busy_until = 0;
+		q.sent = q.dropped = 0;
+		q.wait = 0;
+		q.rate = 0;
+		if (__check_client(i))
+			continue;
+
+		q.rate = datarate;
+		for (cGate *g = gate("face$o", i); g->getNextGate() != NULL; g = g->getNextGate())
 		{
-//			for(int j=0; j < numPercentiles; j++)
-//			{
-//				//avgBitPerSec = numBits[i]/SIMTIME_DBL(simTime());
-//				//currentBitPerSec = numBits[i]/simDuration;
-//				currentBitPerSec = numBits[i][j]/SIMTIME_DBL(simTime());
-//				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
-//				cumSumChLoad += currentChLoad;
-//				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-//				cout << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " IN - Percentile # " << percentiles[j]*100 <<  "th:\t" << cumSumChLoad << endl;
-//			}
-//			cumSumChLoad = 0.0;
-
-			// Without percentiles
-				//avgBitPerSec = numBits[i]/SIMTIME_DBL(simTime());
-				//currentBitPerSec = numBits[i]/simDuration;
-				currentBitPerSec = numBits[i]/SIMTIME_DBL(simTime());
-				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
-				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-				if(numBits[i] != 0 )
-					cout << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
-				else
-					cout << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = 0" << endl;
+			cDatarateChannel *ch = dynamic_cast<cDatarateChannel *>(g->getChannel());
+			if (ch != NULL && ch->getDatarate() > 0)
+				q.rate = ch->getDatarate();
 		}
+		q.limit = (double) queue_limit * link_load_monitor::DATA_BITS;
 	}
-	else
+}
+
+/*
+ * 	Queues a packet of 'bits' bits on a face. Returns false if the packet is dropped (drop-tail),
+ * 	otherwise 'delay' is set to the time it spends in the queue plus its serialization time.
+ */
+bool core_layer::face_enqueue(int face, double bits, simtime_t &delay)
+{
+	face_queue &q = face_queues[face];
+	if (q.rate == 0)
+		return true;
+
+	simtime_t now = simTime();
+	simtime_t start = q.busy_until > now ? q.busy_until : now;
+	double queued = SIMTIME_DBL(start) - SIMTIME_DBL(now);		// Time to transmit the backlog.
+	if (q.limit > 0 && queued * q.rate >= q.limit)
 	{
-		for(int i=0; i < gateSize("face$o") - 1; i++)
-		{
-			// With percentiles
-//			for(int j=0; j < numPercentiles; j++)
-//			{
-//				currentBitPerSec = intvlNumBits[i][j]/maxInterval;
-//				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
-//				cumSumChLoad += currentChLoad;
-//				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-//				cout << SIMTIME_DBL(simTime()) << "\tLink Load Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " IN - Percentile # " << percentiles[j]*100 <<  "th:\t" << cumSumChLoad << endl;
-//				intvlNumBits[i][j] = 0;
-//				intvlNumPackets[i][j] = 0;
-//			}
-//			cumSumChLoad = 0.0;
-
-			// Without percentiles
-				currentBitPerSec = intvlNumBits[i]/maxInterval;
-				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
-				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-				cout << SIMTIME_DBL(simTime()) << "\tLink Load Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
-				intvlNumBits[i] = 0;
-				intvlNumPackets[i] = 0;
+		q.dropped++;
+		return false;
+	}
+
+	q.busy_until = start + bits / q.rate;
+	q.sent++;
+	q.wait += queued;
+	delay = q.busy_until - now;
+	return true;
+}
+
+/*
+ * 	Returns true if a packet sent through the given face can take the fluid fast path.
+ * 	Disabled links (see link failures in the strategy layer) always take the standard path, so that
+ * 	packets are dropped by the channel.
+ */
+bool core_layer::fluid_reachable(int face)
+{
+	if (!fluid || fluid_links[face].peer == NULL)
+		return false;
+	return fluid_links[face].channel == NULL || !fluid_links[face].channel->isDisabled();
+}
+
+/*
+ * 	Sends a packet through the fluid fast path. It will reach the neighbor after 'delay' plus
+ * 	the propagation delay of the link, as if it had crossed the channel.
+ */
+void core_layer::fluid_send(cMessage *msg, int face, simtime_t delay)
+{
+	fluid_link &link = fluid_links[face];
+	link.peer->fluid_deliver(msg, link.peer_gate, simTime() + delay + link.delay);
+}
+
+/*
+ * 	Receives a packet from a neighbor through the fluid fast path. Packets are kept ordered by
+ * 	arrival time and a single timer, scheduled at the earliest arrival, delivers them.
+ */
+void core_layer::fluid_deliver(cMessage *msg, int gate, simtime_t time)
+{
+	Enter_Method_Silent();
+	take(msg);
+
+	fluid_arrival arrival;
+	arrival.time = time;
+	arrival.seq = fluid_seq++;
+	arrival.msg = msg;
+	arrival.gate = gate;
+	fluid_queue.push(arrival);
+
+	if (fluid_queue.top().seq == arrival.seq)	// The new packet is the first one to be delivered.
+	{
+		if (fluid_timer->isScheduled())
+			cancelEvent(fluid_timer);
+		scheduleAt(time, fluid_timer);
+	}
+}
+
+core_layer::~core_layer()
+{
+	while (!fluid_queue.empty())
+	{
+		delete fluid_queue.top().msg;
+		fluid_queue.pop();
+	}
+	if (fluid_timer != NULL)
+		cancelAndDelete(fluid_timer);
+	if (load_check != NULL)
+		cancelAndDelete(load_check);
+	if (pit_check != NULL)
+		cancelAndDelete(pit_check);
+	for (unsigned f = 0; f < ll_vectors.size(); f++)
+		delete ll_vectors[f];
+}
+
+int core_layer::getOutInt(int dest)
+{
+	return strategy->get_out_interface(dest);
+}
 
+/*
+ * 	End of a measurement interval: the load of each face during the interval is appended
+ * 	to the "link_load" table of the results sink (row: interval, column: "<node>-><next node>"),
+ * 	or to an output vector per face if the sink is disabled.
+ */
+void core_layer::evaluateLinkLoad()
+{
+	results_sink &sink = results_sink::get();
+	uint32_t row = (uint32_t) floor(SIMTIME_DBL(simTime()) / maxInterval + 0.5) - 1;
+	if (ll_names.empty())
+		for (int f = 1; f < gateSize("face$o"); f++)
+		{
+			std::stringstream name;
+			name<<getIndex()<<"->"<<getParentModule()->gate("face$o",f)->getNextGate()->getOwnerModule()->getIndex();
+			ll_names.push_back(name.str());
+			if (!sink.is_open())
+				ll_vectors.push_back(new cOutVector(("link_load " + name.str()).c_str()));
 		}
-	}*/
+
+	for (unsigned f = 0; f < ll_names.size(); f++)
+	{
+		double load = link_loads.end_interval(f) / maxInterval / datarate;
+		if (sink.is_open())
+			sink.record("link_load", row, ll_names[f], load);
+		else
+			ll_vectors[f]->record(load);
+	}
 }
 
 
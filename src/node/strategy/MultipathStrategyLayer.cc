@@ -32,11 +32,232 @@
 #include <algorithm>
 #include "MultipathStrategyLayer.h"
 #include "ccnsim.h"
+#include "ccn_interest.h"
 #include "error_handling.h"
 
-//Register_Class(MultipathStrategyLayer);
+Register_Class(MultipathStrategyLayer);
 
 void MultipathStrategyLayer::initialize()
 {
-    severe_error(__FILE__,__LINE__,"You must override this method");
+	strategy_layer::initialize();
+	rng = ccn_rng(this, 0);
+
+	string adapt = par("split_adaptation").stdstringValue();
+	if (adapt == "none")
+		adaptation = ADAPT_NONE;
+	else if (adapt == "pending")
+		adaptation = ADAPT_PENDING;
+	else if (adapt == "rtt")
+		adaptation = ADAPT_RTT;
+	else
+	{
+		std::stringstream msg;
+		msg<<"split_adaptation="<<adapt<<" is not valid: it must be none, pending or rtt";
+		severe_error(__FILE__,__LINE__,msg.str().c_str() );
+	}
+	split_interval = par("split_interval");
+	pending_timeout = par("pending_timeout");
+
+	face_state idle;
+	idle.forwarded[0] = idle.forwarded[1] = 0;
+	idle.satisfied[0] = idle.satisfied[1] = 0;
+	idle.rtt = 0;
+	face_states.assign(getParentModule()->gateSize("face$o"), idle);
+	period_start = 0;
+}
+
+void MultipathStrategyLayer::finish()
+{
+	strategy_layer::finish();
+}
+
+// All the equal-cost paths are kept inside the FIB.
+vector<int> MultipathStrategyLayer::choose_paths(int num_paths)
+{
+	vector<int> v;
+	for (int i=0; i<num_paths; i++)
+		v.push_back( i );
+	return v;
+}
+
+int MultipathStrategyLayer::decide_target_repository(ccn_interest *interest)
+{
+	int repository;
+	if (interest->getRep_target() == UNDEFINED_VALUE)
+	{
+		// Choose one of the repositories storing the content.
+		repo_range repos = interest->repos();
+		repository = repos[rng.intrand(repos.size())];
+		interest->setRep_target(repository);
+	}else
+		repository = interest->getRep_target();
+
+	return repository;
+}
+
+interface_t MultipathStrategyLayer::get_decision(cMessage *in)
+{
+	interface_t decision = 0;
+	if (in->getKind() != CCN_I)
+		return decision;
+
+	ccn_interest *interest = (ccn_interest *)in;
+	next_hop_set &hops = get_next_hops(decide_target_repository(interest));
+	if (adaptation != ADAPT_NONE && simTime() - hops.updated >= split_interval)
+		update_weights(hops);
+
+	int out_gate = choose_face(hops);
+	__sface(decision, out_gate);
+
+	if (adaptation == ADAPT_PENDING)
+	{
+		if (simTime() - period_start >= pending_timeout)
+			new_period();
+		face_states[out_gate].forwarded[0]++;
+	}
+	return decision;
+}
+
+/*
+ * 	PIT entry satisfied by a Data received through 'face', 'rtt' seconds after the Interest has
+ * 	been forwarded: one Interest less is pending on the face, and 'rtt' is a sample of its RTT.
+ */
+void MultipathStrategyLayer::interest_satisfied(chunk_t, int face, double rtt)
+{
+	face_state &f = face_states[face];
+	if (adaptation == ADAPT_PENDING)
+		f.satisfied[0]++;
+	else if (adaptation == ADAPT_RTT)
+		f.rtt = (f.rtt == 0) ? rtt : 0.875 * f.rtt + 0.125 * rtt;
+}
+
+/*
+ * 	Next hops towards a destination. The set is built from the FIB entries the first time, and
+ * 	rebuilt if the FIB has changed since then (e.g., new routes after a link failure).
+ */
+MultipathStrategyLayer::next_hop_set &MultipathStrategyLayer::get_next_hops(int destination)
+{
+	fib_span entries = get_FIB_entries(destination);
+	next_hop_set &hops = next_hops[destination];
+
+	bool valid = (hops.faces.size() == entries.size());
+	for (unsigned i = 0; valid && i < entries.size(); i++)
+		valid = (hops.faces[i] == entries[i].id);
+	if (valid && !hops.faces.empty())
+		return hops;
+
+	if (entries.empty())
+	{
+		std::stringstream msg;
+		msg<<"Node "<<getParentModule()->getIndex()<<" has no FIB entry towards node "<<destination;
+		severe_error(__FILE__,__LINE__,msg.str().c_str() );
+	}
+	hops.faces.clear();
+	for (unsigned i = 0; i < entries.size(); i++)
+		hops.faces.push_back(entries[i].id);
+	update_weights(hops);
+	return hops;
+}
+
+/*
+ * 	Weights of the next hops and their alias table (Vose's method, O(number of next hops)).
+ */
+void MultipathStrategyLayer::update_weights(next_hop_set &hops)
+{
+	unsigned n = hops.faces.size();
+	vector<double> w(n);
+	double sum = 0, known_rtt = 0;
+	unsigned rtt_samples = 0;
+
+	if (adaptation == ADAPT_RTT)
+		for (unsigned i = 0; i < n; i++)
+			if (face_states[hops.faces[i]].rtt > 0)
+			{
+				known_rtt += face_states[hops.faces[i]].rtt;
+				rtt_samples++;
+			}
+
+	for (unsigned i = 0; i < n; i++)
+	{
+		const face_state &f = face_states[hops.faces[i]];
+		w[i] = base_weight(hops.faces[i]);
+		if (adaptation == ADAPT_PENDING)
+			w[i] /= 1. + pending(f);
+		else if (adaptation == ADAPT_RTT && rtt_samples > 0)
+			w[i] /= (f.rtt > 0) ? f.rtt : known_rtt / rtt_samples;	// Faces not measured yet get the average RTT.
+		sum += w[i];
+	}
+	if (sum <= 0)
+	{
+		w.assign(n, 1.);
+		sum = n;
+	}
+
+	hops.prob.assign(n, 0);
+	hops.alias.assign(n, 0);
+	vector<uint32_t> small, large;
+	for (unsigned i = 0; i < n; i++)
+	{
+		hops.prob[i] = w[i] * n / sum;
+		if (hops.prob[i] < 1)
+			small.push_back(i);
+		else
+			large.push_back(i);
+	}
+	while (!small.empty() && !large.empty())
+	{
+		uint32_t s = small.back(), l = large.back();
+		small.pop_back();
+		hops.alias[s] = l;
+		hops.prob[l] -= 1 - hops.prob[s];
+		if (hops.prob[l] < 1)
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	// Leftovers are 1 up to rounding errors.
+	for (unsigned i = 0; i < small.size(); i++)
+		hops.prob[small[i]] = 1;
+	for (unsigned i = 0; i < large.size(); i++)
+		hops.prob[large[i]] = 1;
+
+	hops.updated = simTime();
+}
+
+int MultipathStrategyLayer::choose_face(const next_hop_set &hops)
+{
+	unsigned n = hops.faces.size();
+	if (n == 1)
+		return hops.faces[0];
+
+	double u = rng.uniform() * n;
+	unsigned column = (unsigned) u;
+	if (column >= n)
+		column = n - 1;
+	return hops.faces[(u - column < hops.prob[column]) ? column : hops.alias[column]];
+}
+
+/*
+ * 	Interests whose Data never came back (e.g., aggregated upstream with a PIT entry that has been
+ * 	satisfied through another face, or dropped) must not be counted as pending forever: only the
+ * 	counters of the current and of the previous period are kept.
+ */
+void MultipathStrategyLayer::new_period()
+{
+	for (unsigned i = 0; i < face_states.size(); i++)
+	{
+		face_state &f = face_states[i];
+		f.forwarded[1] = f.forwarded[0];
+		f.satisfied[1] = f.satisfied[0];
+		f.forwarded[0] = f.satisfied[0] = 0;
+	}
+	period_start = simTime();
+}
+
+unsigned long MultipathStrategyLayer::pending(const face_state &f) const
+{
+	unsigned long forwarded = f.forwarded[0] + f.forwarded[1];
+	unsigned long satisfied = f.satisfied[0] + f.satisfied[1];
+	return forwarded > satisfied ? forwarded - satisfied : 0;
 }
@@ -0,0 +1,213 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <omnetpp.h>
+#include <algorithm>
+#include "adaptive_forwarding.h"
+#include "ccn_interest.h"
+#include "error_handling.h"
+#include "results_sink.h"
+#include <sstream>
+
+
+Register_Class(adaptive_forwarding);
+
+
+void adaptive_forwarding::initialize(){
+	strategy_layer::initialize();
+	rng = ccn_rng(this, 0);
+
+	int b = par("buckets");
+	probe_probability = par("probe_probability");
+	if (b <= 0 || probe_probability < 0 || probe_probability > 1)
+	{
+		std::stringstream ermsg;
+		ermsg<<"buckets="<<b<<" and probe_probability="<<probe_probability<<
+			" are not valid: buckets must be positive and probe_probability in [0,1]";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	buckets = b;
+	faces = getParentModule()->gateSize("face$o");
+
+	face_record empty;
+	empty.srtt = 0;
+	empty.forwarded = 0;
+	empty.satisfied = 0;
+	table.assign((size_t) buckets * faces, empty);
+
+	probes = 0;
+	switches = 0;
+}
+
+
+void adaptive_forwarding::finish(){
+	int index = getParentModule()->getIndex();
+	record_result(this, "node", index, "adaptive_probes", probes);		// Interests sent through a probed face.
+	record_result(this, "node", index, "adaptive_switches", switches);	// Interests moved away from the nearest repository's face.
+	strategy_layer::finish();
+}
+
+
+// All the equal-cost paths are kept inside the FIB: the strategy adapts among them.
+vector<int> adaptive_forwarding::choose_paths(int num_paths){
+	vector<int> v;
+	for (int i=0; i<num_paths; i++)
+		v.push_back( i );
+	return v;
+}
+
+
+interface_t adaptive_forwarding::get_decision(cMessage *in){
+
+    interface_t decision = 0;
+    if (in->getKind() == CCN_I){
+	ccn_interest *interest = (ccn_interest *)in;
+	decision = exploit(interest);
+    }
+    return decision;
+
+}
+
+
+/*
+ * 	Ranking metric of a face: the smoothed RTT inflated by the unsatisfied Interests
+ * 	(the +1 terms keep faces with few samples from being discarded too early).
+ */
+double adaptive_forwarding::cost(const face_record &r) const
+{
+	double ratio = (r.satisfied + 1.) / (r.forwarded + 1.);
+	return r.srtt / ratio;
+}
+
+
+// Add the next hops towards 'repository' to the candidates (the arrival face is excluded).
+void adaptive_forwarding::add_candidates(int repository, int arrival_face)
+{
+	fib_span entries = get_FIB_entries(repository);
+	for (unsigned i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].id == arrival_face)
+			continue;
+
+		unsigned j = 0;
+		while (j < candidates.size() && candidates[j].face != entries[i].id)
+			j++;
+		if (j == candidates.size())
+		{
+			candidate c;
+			c.face = entries[i].id;
+			c.len = entries[i].len;
+			c.repository = repository;
+			candidates.push_back(c);
+		}
+		else if (entries[i].len < candidates[j].len)	// Keep the nearest repository behind each face.
+		{
+			candidates[j].len = entries[i].len;
+			candidates[j].repository = repository;
+		}
+	}
+}
+
+
+interface_t adaptive_forwarding::exploit(ccn_interest *interest){
+
+	chunk_t chunk = interest->getChunk();
+	int arrival_face = interest->getArrivalGate()->getIndex();
+
+	candidates.clear();
+	if (interest->getRep_target() == UNDEFINED_VALUE)
+	{
+		repo_range repos = interest->repos();
+		for (repo_iterator i = repos.begin(); i != repos.end(); ++i)
+			add_candidates(*i, arrival_face);
+	}
+	else
+		add_candidates(interest->getRep_target(), arrival_face);
+
+	if (candidates.empty())
+	{
+		std::stringstream ermsg;
+		ermsg<<"Node "<<getParentModule()->getIndex()<<" has no face to forward the Interest for chunk "<<
+			__id(chunk)<<" (arrival face "<<arrival_face<<")";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	// Nearest candidate (static choice) and best measured one.
+	unsigned nearest = 0, best = candidates.size();
+	double best_cost = 0;
+	for (unsigned i = 0; i < candidates.size(); i++)
+	{
+		if (candidates[i].len < candidates[nearest].len)
+			nearest = i;
+		const face_record &r = record(chunk, candidates[i].face);
+		if (r.srtt > 0 && (best == candidates.size() || cost(r) < best_cost))
+		{
+			best = i;
+			best_cost = cost(r);
+		}
+	}
+	unsigned chosen = (best < candidates.size()) ? best : nearest;
+
+	if (candidates.size() > 1 && rng.uniform() < probe_probability)
+	{	// Probe one of the other candidates.
+		unsigned other = rng.intrand(candidates.size() - 1);
+		chosen = (other >= chosen) ? other + 1 : other;
+		probes++;
+	}
+	if (candidates[chosen].len > candidates[nearest].len)
+		switches++;
+
+	if (interest->getRep_target() == UNDEFINED_VALUE)
+		interest->setRep_target(candidates[chosen].repository);
+
+	face_record &r = record(chunk, candidates[chosen].face);
+	if (++r.forwarded >= AGING_THRESHOLD)
+	{
+		r.forwarded /= 2;
+		r.satisfied /= 2;
+	}
+
+    interface_t decision = 0;
+    __sface(decision, candidates[chosen].face);
+    return decision;
+}
+
+
+/*
+ * 	PIT entry of 'chunk' satisfied by a Data received through 'face', 'rtt' seconds after the
+ * 	Interest has been forwarded.
+ */
+void adaptive_forwarding::interest_satisfied(chunk_t chunk, int face, double rtt)
+{
+	face_record &r = record(chunk, face);
+	if (r.satisfied < r.forwarded)
+		r.satisfied++;
+	r.srtt = (r.srtt == 0) ? rtt : 0.875 * r.srtt + 0.125 * rtt;
+}
@@ -90,9 +90,9 @@ void nrr::initialize(){
     sort(cfib.begin(), cfib.end());
 }
 
-bool *nrr::get_decision(cMessage *in){
+interface_t nrr::get_decision(cMessage *in){
 
-    bool *decision;
+    interface_t decision = 0;
     if (in->getKind() == CCN_I){
 		ccn_interest *interest = (ccn_interest *)in;
 		decision = exploit(interest);
@@ -104,19 +104,16 @@ bool *nrr::get_decision(cMessage *in){
 
 
 //The nearest repository just exploit the host-centric FIB. 
-bool *nrr::exploit(ccn_interest *interest){
+interface_t nrr::exploit(ccn_interest *interest){
 
     int repository,
 	node,
 	output_iface,
-	gsize,
 	times;
 
 	output_iface = -1;
 
-    gsize = __get_outer_interfaces();
-    bool *decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
+    interface_t decision = 0;
 
 	//<aa>
 	#ifdef SEVERE_DEBUG
@@ -146,7 +143,7 @@ bool *nrr::exploit(ccn_interest *interest){
 		vector<Centry>::iterator it = 
 			std::find_if (cfib.begin(),cfib.end(),lookup(interest->getChunk()) );
 
-		vector<int> repos = interest->get_repos();
+		repo_range repos = interest->repos();
 		repository = nearest(repos);
 
 		//<aa>
@@ -280,7 +277,7 @@ bool *nrr::exploit(ccn_interest *interest){
 	//<aa>
 	else if (interest->getTarget() == getIndex() )
 	{
-		vector<int> repos = interest->get_repos();
+		repo_range repos = interest->repos();
 		repository = nearest(repos);
 		const int_f FIB_entry = get_FIB_entry(repository);
 
@@ -320,16 +317,16 @@ bool *nrr::exploit(ccn_interest *interest){
 	#endif
 	//</aa>
 
-    decision[output_iface] = true;
+    __sface(decision, output_iface);
     return decision;
 }
 
 /*
  * 		Exploit function for the model execution with NRR.
  */
-bool *nrr::exploit_model(long content){
+interface_t nrr::exploit_model(long content){
 
-	// We should return a vector of bool indicating the output interfaces.
+	// We should return a bitmask indicating the output interfaces.
 	// CONSIDER: Nel modello, quando si calcola il rate in ingresso ad un nodo, e quindi le p_hit dei vicini,
 	//			 abbiamo bisogno di un modo per determinare il numero di potenziali destinatari (con out interface
 	//			 diverse) a cui i vicini possono inviare (random) l'Interest ricevuto, in modo da stabilire volta
@@ -338,11 +335,7 @@ bool *nrr::exploit_model(long content){
 	//cout << "*** Exploit MODEL *** Node # " << getIndex() << " with # " << __get_outer_interfaces() << " interf" << endl;
 
 	unsigned long long m = (unsigned long long)content;
-    int	gsize;
-
-    gsize = __get_outer_interfaces();
-    bool *output_ifaces = new bool[gsize];
-    fill_n(output_ifaces, gsize, false);
+    interface_t output_ifaces = 0;
 
     // Find the first occurrence in the sorted vector of caches.
 	vector<Centry>::iterator it = std::find_if (cfib.begin(),cfib.end(),lookup(m) );
@@ -390,49 +383,44 @@ bool *nrr::exploit_model(long content){
 		for(uint32_t i=0; i < potential_targets.size(); i++)
 		{
 			node = potential_targets[i];
-			output_ifaces[get_FIB_entry(node).id] = true;
+			__sface(output_ifaces, get_FIB_entry(node).id);
 		}
 	}
 	else  //not found
 	{
 		//<aa> There are no alternatives to the FIB entry to reach the content</aa>
-		output_ifaces[FIB_entry.id] = true;
+		__sface(output_ifaces, FIB_entry.id);
 	}
     return output_ifaces;
 }
 
 
-int nrr::nearest(vector<int>& repositories){
-    int  min_len = 10000;
-    vector<int> targets
-	//<aa>
-			(0);
-	//</aa>
+int nrr::nearest(repo_range repositories){
+	#ifdef SEVERE_DEBUG
+	if (repositories.size()==0)
+		severe_error(__FILE__,__LINE__, "repositories has 0 elements");
+	#endif
 
-    for (vector<int>::iterator i = repositories.begin(); i!=repositories.end();i++){ 		//Find the shortest (the minimum)
+    // First pass: minimum FIB distance and number of repositories at that distance.
+    int  min_len = 10000;
+    int ties = 0;
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i){ 	//Find the shortest (the minimum)
     	//<aa>
     	const int_f FIB_entry = get_FIB_entry(*i);
     	//</aa>
         if (FIB_entry.len < min_len ){
             min_len = FIB_entry.len;
-            targets.clear();
-            targets.push_back(*i);
+            ties = 1;
         }else if (FIB_entry.len == min_len)
-		    targets.push_back(*i);
+            ties++;
     }
 
-	//<aa>
-	#ifdef SEVERE_DEBUG
-	if (repositories.size() == 0){
-		std::stringstream ermsg; 
-		ermsg<<"There are 0 repositories. It's not admitted";
-		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-	}
-	int test = targets[0]; // Just to see if targets is properly allocated
-	#endif
-	//</aa>
-
-    return targets[intrand(targets.size())];
+    // Second pass: pick one of the nearest repositories uniformly at random (without building a vector).
+    int select = intrand(ties);
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i)
+        if (get_FIB_entry(*i).len == min_len && select-- == 0)
+            return *i;
+    return *repositories.begin();	// Not reached.
 }
 
 void nrr::finish(){
@@ -34,11 +34,8 @@
 Register_Class(nrr1);
 
 
-bool *nrr1::get_decision(cMessage *in){//check this function
-    bool *decision;
-    int gsize = __get_outer_interfaces();
-    decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
+interface_t nrr1::get_decision(cMessage *in){//check this function
+    interface_t decision = 0;
     ccn_interest *interest;
     int dyn_TTL = par("TTL1");
 
@@ -48,9 +45,7 @@ bool *nrr1::get_decision(cMessage *in){//check this function
 	if (interest->getNfound()){
 	    decision = exploit_nearest(interest);
 	}else if (interest->getHops() >= dyn_TTL){
-	    int gsize = __get_outer_interfaces();
-	    decision = new bool[gsize];
-	    std::fill(decision,decision+gsize,0);
+	    decision = 0;
 	}else {
             decision  = explore(interest);
         }
@@ -64,17 +59,17 @@ bool *nrr1::get_decision(cMessage *in){//check this function
  * Explore the network if the target is not yet defined. The target is the node
  * (repository or cache) which stores the nearest copy of the data.
  */
-bool *nrr1::explore(ccn_interest *interest){
+interface_t nrr1::explore(ccn_interest *interest){
     int arrival_gate,
         gsize;
-    bool *decision;
+    interface_t decision;
 
     gsize = __get_outer_interfaces();
     arrival_gate = interest->getArrivalGate()->getIndex();
-    decision = new bool[gsize];
 
-    std::fill(decision,decision+gsize,1);
-    decision[arrival_gate] = false;
+    // All the interfaces but the arrival one.
+    decision = gsize >= (int)sizeof(interface_t)*8 ? ~(interface_t)0 : ((interface_t)1 << gsize) - 1;
+    __uface(decision, arrival_gate);
     return decision;
 }
 
@@ -87,15 +82,13 @@ bool *nrr1::explore(ccn_interest *interest){
  * given target that explores again the network looking for content close to
  * himself.
  */
-bool *nrr1::exploit(ccn_interest *interest){
+interface_t nrr1::exploit(ccn_interest *interest){
 
 
-    bool *decision;
+    interface_t decision = 0;
     int outif,
-	gsize,
 	target;
 
-    gsize = __get_outer_interfaces();
     target = interest->getTarget();
 
     if (interest->getTarget() == getIndex()){//failure
@@ -108,23 +101,18 @@ bool *nrr1::exploit(ccn_interest *interest){
 	//</aa>
     outif = FIB_entry.id;
 
-    decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
-    decision[outif]=true;
+    __sface(decision, outif);
 
     return decision;
 
 }
 
-bool *nrr1::exploit_nearest(ccn_interest *interest){
+interface_t nrr1::exploit_nearest(ccn_interest *interest){
 
     int repository,
-        outif,
-        gsize;
-
-    gsize = __get_outer_interfaces();
+        outif;
 
-    vector<int> repos = interest->get_repos();
+    repo_range repos = interest->repos();
     repository = nearest(repos);
 
 	//<aa>
@@ -133,30 +121,38 @@ bool *nrr1::exploit_nearest(ccn_interest *interest){
     outif = FIB_entry.id;
 
 
-    bool *decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
-    decision[outif]=true;
+    interface_t decision = 0;
+    __sface(decision, outif);
 
     return decision;
 
 }
 
-int nrr1::nearest(vector<int>& repositories){
-    int  min_len = 10000;
-    vector<int> targets;
+int nrr1::nearest(repo_range repositories){
+	#ifdef SEVERE_DEBUG
+	if (repositories.size()==0)
+		severe_error(__FILE__,__LINE__, "repositories has 0 elements");
+	#endif
 
-    for (vector<int>::iterator i = repositories.begin(); i!=repositories.end();i++){ 	//Find the shortest (the minimum)
+    // First pass: minimum FIB distance and number of repositories at that distance.
+    int  min_len = 10000;
+    int ties = 0;
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i){ 	//Find the shortest (the minimum)
     	//<aa>
     	const int_f FIB_entry = get_FIB_entry(*i);
     	//</aa>
         if (FIB_entry.len < min_len ){
             min_len = FIB_entry.len;
-	    targets.clear();
-            targets.push_back(*i);
+            ties = 1;
         }else if (FIB_entry.len == min_len)
-	    targets.push_back(*i);
-
+            ties++;
     }
-    return targets[intrand(targets.size())];
+
+    // Second pass: pick one of the nearest repositories uniformly at random (without building a vector).
+    int select = intrand(ties);
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i)
+        if (get_FIB_entry(*i).len == min_len && select-- == 0)
+            return *i;
+    return *repositories.begin();	// Not reached.
 }
 
@@ -34,9 +34,9 @@
 
 Register_Class(parallel_repository);
 
-bool *parallel_repository::get_decision(cMessage *in){//check this function
+interface_t parallel_repository::get_decision(cMessage *in){//check this function
 
-    bool *decision;
+    interface_t decision = 0;
     if (in->getKind() == CCN_I){
 	ccn_interest *interest = (ccn_interest *)in;
 	decision = exploit(interest);
@@ -47,23 +47,19 @@ bool *parallel_repository::get_decision(cMessage *in){//check this function
 
 
 
-bool *parallel_repository::exploit(ccn_interest *interest){
+interface_t parallel_repository::exploit(ccn_interest *interest){
 
-    int outif,
-	gsize;
+    int outif;
+    interface_t decision = 0;
 
-    gsize = __get_outer_interfaces();
-    bool *decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
-
-    vector<int> repos = (interest->get_repos());
-    for (vector<int>::iterator it = repos.begin(); it!=repos.end();it++){
+    repo_range repos = interest->repos();
+    for (repo_iterator it = repos.begin(); it!=repos.end(); ++it){
     
     //<aa>
     const int_f FIB_entry = get_FIB_entry(*it);
     //</aa>
 	outif = FIB_entry.id;
-	decision[outif]=true;
+	__sface(decision, outif);
     }
 
     return decision;
@@ -34,8 +34,8 @@
 
 Register_Class(random_repository);
 
-bool *random_repository::get_decision(cMessage *in){//check this function
-    bool *decision;
+interface_t random_repository::get_decision(cMessage *in){//check this function
+    interface_t decision = 0;
     if (in->getKind() == CCN_I){
 	ccn_interest *interest = (ccn_interest *)in;
 	 decision = exploit(interest);
@@ -46,13 +46,10 @@ bool *random_repository::get_decision(cMessage *in){//check this function
 
 
 
-bool *random_repository::exploit(ccn_interest *interest){
+interface_t random_repository::exploit(ccn_interest *interest){
 
     int repository,
-	outif,
-	gsize;
-
-    gsize = __get_outer_interfaces(); //<aa> number of gates</aa>
+	outif;
 
     //if (interest->getRep_target == ccn_interest_Base.UNDEFINED_VALUE)
 	if(1)
@@ -60,7 +57,7 @@ bool *random_repository::exploit(ccn_interest *interest){
 		severe_error(__FILE__, __LINE__, "Leva il fatto dell'1");
     	//<aa> Get all the repositories that store the content demanded by the
     	// interest </aa>
-		vector<int> repos = interest->get_repos();
+		repo_range repos = interest->repos();
 		
 		//<aa> Choose one of them </aa>
 		repository = random(repos);
@@ -73,14 +70,13 @@ bool *random_repository::exploit(ccn_interest *interest){
 	//</aa>
 
     outif = FIB_entry.id;
-    bool *decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
-    decision[outif]=true;
+    interface_t decision = 0;
+    __sface(decision, outif);
 
     return decision;
 }
 
 
-int random_repository::random(vector<int>& repositories){
+int random_repository::random(repo_range repositories){
     return repositories[intrand(repositories.size())];
 }
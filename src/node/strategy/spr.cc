@@ -40,9 +40,9 @@ Register_Class(spr);
 
 
 
-bool *spr::get_decision(cMessage *in){
+interface_t spr::get_decision(cMessage *in){
 
-    bool *decision;
+    interface_t decision = 0;
     if (in->getKind() == CCN_I){
 	ccn_interest *interest = (ccn_interest *)in;
 	decision = exploit(interest);
@@ -54,15 +54,12 @@ bool *spr::get_decision(cMessage *in){
 
 
 //The nearest repository just exploit the host-centric FIB. 
-bool *spr::exploit(ccn_interest *interest){
+interface_t spr::exploit(ccn_interest *interest){
 
     int repository,
-	outif,
-	gsize;
+	outif;
 
-    gsize = __get_outer_interfaces();
-
-    vector<int> repos = interest->get_repos();
+    repo_range repos = interest->repos();
     repository = nearest(repos);
 
 	//<aa>
@@ -70,36 +67,37 @@ bool *spr::exploit(ccn_interest *interest){
 	//</aa>
     outif = FIB_entry.id;
 
-
-    bool *decision = new bool[gsize];
-    std::fill(decision,decision+gsize,0);
-    
-    decision[outif]=true;
+    interface_t decision = 0;
+    __sface(decision, outif);
 
     return decision;
 
 }
-int spr::nearest(vector<int>& repositories){
+int spr::nearest(repo_range repositories){
 	#ifdef SEVERE_DEBUG
 	if (repositories.size()==0)
 		severe_error(__FILE__,__LINE__, "repositories has 0 elements");
 	#endif
-	
-    int  min_len = 10000;
-    vector<int> targets;
 
-    for (vector<int>::iterator i = repositories.begin(); i!=repositories.end();i++) 	{ 	//Find the shortest (the minimum)
+    // First pass: minimum FIB distance and number of repositories at that distance.
+    int  min_len = 10000;
+    int ties = 0;
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i){ 	//Find the shortest (the minimum)
     	//<aa>
     	const int_f FIB_entry = get_FIB_entry(*i);
     	//</aa>
         if (FIB_entry.len < min_len ){
             min_len = FIB_entry.len;
-            targets.clear();
-            targets.push_back(*i);
+            ties = 1;
         }else if (FIB_entry.len == min_len)
-            targets.push_back(*i);
+            ties++;
     }
-    
-    return targets[intrand(targets.size())];
+
+    // Second pass: pick one of the nearest repositories uniformly at random (without building a vector).
+    int select = intrand(ties);
+    for (repo_iterator i = repositories.begin(); i!=repositories.end(); ++i)
+        if (get_FIB_entry(*i).len == min_len && select-- == 0)
+            return *i;
+    return *repositories.begin();	// Not reached.
 }
 
@@ -287,10 +287,12 @@ void strategy_layer::add_FIB_entry(int destination_node_index, int interface_ind
 	int_f FIB_entry;
 	FIB_entry.id = interface_index;
 	FIB_entry.len = distance;
+	if ((int)FIB.size() <= destination_node_index)
+		FIB.resize(destination_node_index + 1);
 	FIB[destination_node_index].push_back(FIB_entry);
 	
 	#ifdef SEVERE_DEBUG
-	vector<int_f> entry_vec = FIB[destination_node_index];
+	const vector<int_f> &entry_vec = FIB[destination_node_index];
 	int_f entry_just_added = entry_vec.back();
 	int output_gates = getParentModule()->gateSize("face$o");
 	if (entry_just_added.id >= output_gates){
@@ -301,11 +303,15 @@ void strategy_layer::add_FIB_entry(int destination_node_index, int interface_ind
 	#endif
 }
 
-const vector<int_f> strategy_layer::get_FIB_entries(
+fib_span strategy_layer::get_FIB_entries(
 		int destination_node_index)
 {
-	vector<int_f> entries = FIB[destination_node_index] ;
-	return entries;
+	if (destination_node_index < 0 || destination_node_index >= (int)FIB.size()
+			|| FIB[destination_node_index].empty())
+		return fib_span();
+
+	const vector<int_f> &entries = FIB[destination_node_index];
+	return fib_span(&entries[0], &entries[0] + entries.size());
 }
 
 int strategy_layer::get_out_interface(int destination_node)
@@ -319,8 +325,9 @@ int strategy_layer::get_out_interface(int destination_node)
 	}
 	int id = FIB[destination_node].operator [](0).id;*/
 	int id;
-	if (FIB.count(destination_node) > 0)
-		id = FIB.operator [](destination_node).front().id;  // like MonopathStrategy::get_FIB_entry.
+	fib_span entries = get_FIB_entries(destination_node);
+	if (!entries.empty())
+		id = entries.front().id;  // like MonopathStrategy::get_FIB_entry.
 	else
 		id = 1000;
 	return id;
@@ -630,6 +630,218 @@ double compute_Tc_single_Approx_More_Repo(double cSizeTarg, double alphaVal, lon
 }
 
 
+/* Occupancy probability of a content inside a q-LRU cache, with Che's approximation.
+*
+*	Parameters:
+*		- rate: request rate of the content;
+*		- Tc: characteristic time of the cache;
+*		- q: insertion probability of the content.
+*/
+double qlru_pin(double rate, double Tc, double q)
+{
+	if(q*rate*Tc <= 0.01)
+		return q*rate*Tc;
+	return (q * (1.0 - exp(-rate*Tc)))/(exp(-rate*Tc) + q * (1.0 - exp(-rate*Tc)));
+}
+
+/* Compute the Tc of a cache whose insertion probability depends on the content, i.e., a q-LRU with a
+*  per-content q. It models 2-LRU (q is the hit probability of the name cache) and LCD (q is the hit
+*  probability of the upstream cache).
+*
+*	Parameters:
+*		- cSizeTarg: target cache size;
+*		- catCard: cardinality of the catalog;
+*		- reqRates: request rates of the contents at each node;
+*		- colIndex: node;
+*		- qVect: insertion probability of each content at the node.
+*/
+double compute_Tc_single_Approx_qVect(double cSizeTarg, long catCard, float** reqRates, int colIndex, float* qVect)
+{
+  double Tc, Tc1, Tc2;
+  double cacheSizeTemp;
+  long k, iter;
+  int numMaxIter = 20;
+
+  double lambdaTot = 0;
+  for(k=0; k < catCard; k++)
+	  lambdaTot += reqRates[colIndex][k];
+
+  Tc = 0.3 * (cSizeTarg/lambdaTot); // Starting value for the Tc
+
+  iter=0;
+  do {
+     cacheSizeTemp = 0.0;
+     for (k=0; k<catCard; k++)
+    	 cacheSizeTemp += qlru_pin(reqRates[colIndex][k], Tc, qVect[k]);
+     Tc = Tc * 2.0;
+     iter++;
+  } while (cacheSizeTemp < cSizeTarg && (iter < numMaxIter));
+
+  if(iter == 1)
+  {
+    printf("error Tc too small");
+    exit(0);
+  }
+  if(iter == numMaxIter)
+  {
+    printf("Error: Tc too large for Node # %d\n", colIndex);
+    Tc = 5000;
+    return Tc;
+  }
+
+  Tc2=Tc/2.0;
+  Tc1=Tc/4.0;
+
+  do {
+     Tc = (Tc1+Tc2)/2.0;
+     cacheSizeTemp = 0.0;
+     for (k=0; k<catCard; k++)
+    	 cacheSizeTemp += qlru_pin(reqRates[colIndex][k], Tc, qVect[k]);
+     if (cacheSizeTemp < cSizeTarg)
+        Tc1 = Tc;
+     else
+        Tc2 = Tc;
+    } while (fabs(cacheSizeTemp-cSizeTarg)/cSizeTarg > 0.001);
+
+    return Tc;
+}
+
+
+/* ON/OFF request process of a content (Shot Noise Model): Poisson requests with rate 'rate' during ON periods,
+*  exponentially distributed with rate 'mu' (i.e., mean Ton = 1/mu), separated by deterministic OFF periods of
+*  length 'toff'. Inter-request times are i.i.d.: after each request, the next event is either a request (with
+*  probability p = rate/(rate+mu)) or the end of the ON period, after an Exp(rate+mu) time; in the latter case,
+*  the race starts again after the OFF period. Hence, an inter-request time made of j OFF periods is Erlang(j+1)
+*  distributed plus j*toff, and its CDF is
+*
+*  		F(t) = sum_j (1-p)^j * p * Erlang_{j+1}(t - j*toff),		j*toff < t.
+*
+*  mu = 0 (or toff = 0) means that the content is always ON (IRM).
+*/
+
+/* Hit probability of a request for an LRU cache with characteristic time Tc: F(Tc).
+*/
+double onoff_phit(double rate, double Tc, double mu, double toff)
+{
+	if(mu == 0 || toff == 0)
+		return -expm1(-rate*Tc);
+
+	double nu = rate + mu;
+	double p = rate / nu;
+	double weight = p;		// (1-p)^j * p
+	double phit = 0;
+	for(long j=0; j*toff < Tc && weight > 1e-12; j++)
+	{
+		double y = nu*(Tc - j*toff);
+		double term = exp(-y), surv = 0;	// Survival function of the Erlang(j+1).
+		for(long i=0; i <= j; i++)
+		{
+			surv += term;
+			term *= y/(i+1);
+		}
+		phit += weight * ((j == 0) ? -expm1(-y) : 1 - surv);
+		weight *= (1-p);
+	}
+	return phit;
+}
+
+/* Occupancy probability of the content, i.e., the probability that the age of its last request is
+*  smaller than Tc: (mean request rate) * integral(0,Tc)(1 - F(t)) dt, where
+*  integral(0,x) Erlang_{k}(s) ds = x - (1/nu) * sum_{i=1..k} Erlang_{i}(x).
+*/
+double onoff_pin(double rate, double Tc, double mu, double toff)
+{
+	if(mu == 0 || toff == 0)
+	{
+		if(rate*Tc <= 0.01)
+			return rate*Tc;
+		return -expm1(-rate*Tc);
+	}
+
+	double nu = rate + mu;
+	double p = rate / nu;
+	double duty = (1./mu) / (1./mu + toff);
+	double weight = p;
+	double intF = 0;			// integral(0,Tc) F(t) dt
+	for(long j=0; j*toff < Tc && weight > 1e-12; j++)
+	{
+		double x = Tc - j*toff;
+		double y = nu*x;
+		double term = exp(-y), surv = 0, sumCdf = 0;
+		for(long i=0; i <= j; i++)
+		{
+			surv += term;
+			term *= y/(i+1);
+			sumCdf += (i == 0) ? -expm1(-y) : 1 - surv;
+		}
+		intF += weight * (x - sumCdf/nu);
+		weight *= (1-p);
+	}
+	return rate * duty * (Tc - intF);
+}
+
+/* Compute the Tc of an LRU cache fed by ON/OFF request processes (see onoff_pin).
+*
+*	Parameters:
+*		- cSizeTarg: target cache size;
+*		- catCard: cardinality of the catalog;
+*		- reqRates: request rates (during ON periods) of the contents at each node;
+*		- colIndex: node;
+*		- mu: inverse of the mean ON period of each content;
+*		- toff: OFF period of each content.
+*/
+double compute_Tc_single_OnOff(double cSizeTarg, long catCard, float** reqRates, int colIndex, float* mu, float* toff)
+{
+  double Tc, Tc1, Tc2;
+  double cacheSizeTemp;
+  long k, iter;
+  int numMaxIter = 20;
+
+  double lambdaTot = 0;
+  for(k=0; k < catCard; k++)
+	  lambdaTot += reqRates[colIndex][k];
+
+  Tc = 0.3 * (cSizeTarg/lambdaTot); // Starting value for the Tc
+
+  iter=0;
+  do {
+     cacheSizeTemp = 0.0;
+     for (k=0; k<catCard; k++)
+    	 cacheSizeTemp += onoff_pin(reqRates[colIndex][k], Tc, mu[k], toff[k]);
+     Tc = Tc * 2.0;
+     iter++;
+  } while (cacheSizeTemp < cSizeTarg && (iter < numMaxIter));
+
+  if(iter == 1)
+  {
+    printf("error Tc too small");
+    exit(0);
+  }
+  if(iter == numMaxIter)
+  {
+    printf("Error: Tc too large for Node # %d\n", colIndex);
+    Tc = 5000;
+    return Tc;
+  }
+
+  Tc2=Tc/2.0;
+  Tc1=Tc/4.0;
+
+  do {
+     Tc = (Tc1+Tc2)/2.0;
+     cacheSizeTemp = 0.0;
+     for (k=0; k<catCard; k++)
+    	 cacheSizeTemp += onoff_pin(reqRates[colIndex][k], Tc, mu[k], toff[k]);
+     if (cacheSizeTemp < cSizeTarg)
+        Tc1 = Tc;
+     else
+        Tc2 = Tc;
+    } while (fabs(cacheSizeTemp-cSizeTarg)/cSizeTarg > 0.001);
+
+    return Tc;
+}
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,253 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Michele Tortelli (Principal suspect 1.0, mailto michele.tortelli@telecom-paristech.fr)
+ *    Andrea Araldo (Principal suspect 1.1, mailto araldo@lri.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *
+ * Mailing list: 
+ *	  ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "results_sink.h"
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <cstring>
+#include "error_handling.h"
+
+using namespace std;
+
+static const char RESULTS_MAGIC[4] = {'C','C','N','R'};
+
+results_sink &results_sink::get()
+{
+	static results_sink sink;
+	return sink;
+}
+
+int results_sink::table::column_index(const string &column) const
+{
+	for (unsigned int c = 0; c < columns.size(); c++)
+		if (columns[c] == column)
+			return c;
+	return -1;
+}
+
+string results_sink::indexed_name(const char *metric, int index)
+{
+	stringstream name;
+	name << metric << "[" << index << "]";
+	return name.str();
+}
+
+/*
+ * 	Enable the sink for the current run. Tables recorded by a previous run
+ * 	(Cmdenv executes all the runs inside the same process) are discarded.
+ */
+void results_sink::open(const string &name)
+{
+	tables.clear();
+	attributes.clear();
+	file_name = name;
+	opened = true;
+}
+
+void results_sink::close()
+{
+	tables.clear();
+	attributes.clear();
+	file_name.clear();
+	opened = false;
+}
+
+void results_sink::set_attribute(const string &key, const string &value)
+{
+	attributes[key] = value;
+}
+
+void results_sink::record(const string &table_name, uint32_t row, const string &column, double value)
+{
+	table &t = tables[table_name];
+	int c = t.column_index(column);
+	if (c < 0)
+	{
+		t.columns.push_back(column);
+		t.values.push_back(vector<double>());
+		c = t.columns.size() - 1;
+	}
+	if (row >= t.rows)
+		t.rows = row + 1;
+
+	vector<double> &col = t.values[c];
+	if (row >= col.size())
+		col.resize(row + 1, numeric_limits<double>::quiet_NaN());
+	col[row] = value;
+}
+
+/*
+ * 	Write the tables of the current run and disable the sink. Per-module metrics are not recorded
+ * 	as scalars when the sink is enabled, so a failed write is a fatal error (the run ends with a
+ * 	non-zero exit status) instead of a silent loss of the results.
+ */
+bool results_sink::write()
+{
+	if (!opened)
+		return false;
+	if (!write_to(file_name))
+	{
+		std::stringstream ermsg;
+		ermsg<<"Impossible to write the results file "<<file_name<<": the results of the run are lost";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	close();
+	return true;
+}
+
+
+// Binary helpers (native byte order, i.e., little endian on the supported platforms).
+static void put_u32(ofstream &out, uint32_t v)
+{
+	out.write((const char*) &v, sizeof(v));
+}
+
+static void put_string(ofstream &out, const string &s)
+{
+	uint16_t len = s.size() > 0xFFFF ? 0xFFFF : s.size();
+	out.write((const char*) &len, sizeof(len));
+	out.write(s.data(), len);
+}
+
+static bool get_u32(ifstream &in, uint32_t &v)
+{
+	return (bool) in.read((char*) &v, sizeof(v));
+}
+
+static bool get_string(ifstream &in, string &s)
+{
+	uint16_t len;
+	if (!in.read((char*) &len, sizeof(len)))
+		return false;
+	s.resize(len);
+	return len == 0 || (bool) in.read(&s[0], len);
+}
+
+bool results_sink::write_to(const string &name) const
+{
+	ofstream out(name.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!out)
+		return false;
+
+	out.write(RESULTS_MAGIC, sizeof(RESULTS_MAGIC));
+	put_u32(out, FORMAT_VERSION);
+
+	put_u32(out, attributes.size());
+	for (map<string,string>::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+	{
+		put_string(out, it->first);
+		put_string(out, it->second);
+	}
+
+	// Schema
+	put_u32(out, tables.size());
+	for (map<string,table>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+	{
+		put_string(out, it->first);
+		put_u32(out, it->second.rows);
+		put_u32(out, it->second.columns.size());
+		for (unsigned int c = 0; c < it->second.columns.size(); c++)
+			put_string(out, it->second.columns[c]);
+	}
+
+	// Columns (padded with NaN up to the number of rows of their table)
+	const double nan = numeric_limits<double>::quiet_NaN();
+	for (map<string,table>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+	{
+		const table &t = it->second;
+		for (unsigned int c = 0; c < t.columns.size(); c++)
+		{
+			const vector<double> &col = t.values[c];
+			if (!col.empty())
+				out.write((const char*) &col[0], col.size() * sizeof(double));
+			for (uint32_t r = col.size(); r < t.rows; r++)
+				out.write((const char*) &nan, sizeof(double));
+		}
+	}
+	return (bool) out;
+}
+
+bool results_sink::read(const string &name)
+{
+	ifstream in(name.c_str(), ios::in | ios::binary);
+	char magic[4];
+	uint32_t version, n;
+
+	tables.clear();
+	attributes.clear();
+
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, RESULTS_MAGIC, sizeof(magic)) != 0)
+		return false;
+	if (!get_u32(in, version) || version != FORMAT_VERSION)
+		return false;
+
+	if (!get_u32(in, n))
+		return false;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		string key, value;
+		if (!get_string(in, key) || !get_string(in, value))
+			return false;
+		attributes[key] = value;
+	}
+
+	vector<string> order;
+	if (!get_u32(in, n))
+		return false;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		string tname;
+		uint32_t cols;
+		if (!get_string(in, tname))
+			return false;
+		table &t = tables[tname];
+		if (!get_u32(in, t.rows) || !get_u32(in, cols))
+			return false;
+		t.columns.resize(cols);
+		t.values.resize(cols);
+		for (uint32_t c = 0; c < cols; c++)
+			if (!get_string(in, t.columns[c]))
+				return false;
+		order.push_back(tname);
+	}
+
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		table &t = tables[order[i]];
+		for (unsigned int c = 0; c < t.columns.size(); c++)
+		{
+			t.values[c].resize(t.rows);
+			if (t.rows && !in.read((char*) &t.values[c][0], t.rows * sizeof(double)))
+				return false;
+		}
+	}
+	return true;
+}
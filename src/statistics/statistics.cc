@@ -29,6 +29,7 @@
  *
  */
 #include <cmath>
+#include <fstream>
 #include "statistics.h"
 #include "core_layer.h"
 #include "base_cache.h"
@@ -40,12 +41,14 @@
 #include "ccn_data.h"
 #include "always_policy.h"
 #include "fix_policy.h"
+#include "lcd_policy.h"
 #include "two_lru_policy.h"
 #include "two_ttl_policy.h"
 //#include "nrr.h"
 #include "client_IRM.h"
 #include "ttl_cache.h"
 #include "ttl_name_cache.h"
+#include "results_sink.h"
 
 //<aa>
 #include "error_handling.h"
@@ -62,6 +65,11 @@ using namespace std;
 
 extern "C" double compute_Tc_single_Approx(double cSizeTarg, double alphaVal, long catCard, float** reqRates, int colIndex, const char* decString, double fixProb);
 extern "C" double compute_Tc_single_Approx_More_Repo(double cSizeTarg, double alphaVal, long catCard, float** reqRates, int colIndex, const char* decString, double fixProb);
+extern "C" double compute_Tc_single_Approx_qVect(double cSizeTarg, long catCard, float** reqRates, int colIndex, float* qVect);
+extern "C" double qlru_pin(double rate, double Tc, double q);
+extern "C" double compute_Tc_single_OnOff(double cSizeTarg, long catCard, float** reqRates, int colIndex, float* mu, float* toff);
+extern "C" double onoff_pin(double rate, double Tc, double mu, double toff);
+extern "C" double onoff_phit(double rate, double Tc, double mu, double toff);
 
 void statistics::initialize(int stage)
 {
@@ -121,6 +129,12 @@ void statistics::initialize(int stage)
         cvThr = par("cvThr");
         consThr = par("consThr");
 
+		// Binary results sink (an empty file name keeps the legacy per-node scalars).
+		results_pending = false;
+		string results_file = par("results_file").stdstringValue();
+		if (!results_file.empty())
+			open_results_sink(results_file);
+
 		if (partial_n < 0 || partial_n > 1)
 		{
 			std::stringstream ermsg;
@@ -161,11 +175,8 @@ void statistics::initialize(int stage)
 		{
 			for (unsigned repo_idx =0; repo_idx < content_distribution::repo_popularity_p->size(); repo_idx++)
 			{
-				char name[30];
-
-				sprintf ( name, "repo_popularity[%u]",repo_idx);
 				double repo_popularity = (*content_distribution::repo_popularity_p)[repo_idx];
-				recordScalar(name,repo_popularity);
+				record_result(this, "repo", repo_idx, "repo_popularity", repo_popularity);
 			}
 
 
@@ -417,6 +428,7 @@ void statistics::handleMessage(cMessage *in)
 					clients[i]->stability = true;
 
 				cout << "*** FULL STABLE ***" << endl;
+				mg_stable = true;
 
 				// *****  NB  *** Insert for the link failure scenario
 				//if(scheduleEnd)
@@ -434,16 +446,11 @@ void statistics::handleMessage(cMessage *in)
 						cout << "Node # " << i << " pHit: " << phitNode << endl;
 						phitNode = 0;
 						numActiveNodes++;
-
-						cores[i]->stable = true;
-
 					}
 					else
 					{
 						phitTot += 0;
 						//numActiveNodes++;
-
-						cores[i]->stable = true;
 					}
 				}
 				cout << "SIMULATION - Total MEAN HIT PROB AFTER STABILIZATION: " << phitTot * 1./(double)numActiveNodes << endl;
@@ -529,7 +536,8 @@ void statistics::handleMessage(cMessage *in)
 
     	    	cout << "CYCLE " << sim_cycles << " -\tNUM of ACTIVE NODES among the PARTIAL_N NODES: " << numActiveNodes << endl;
 
-    	    	if(Sum_avg_as_cur/Sum_target_cache < consThr || sim_cycles > 20)
+    	    	mg_consistency = Sum_avg_as_cur/Sum_target_cache;
+    	    	if(mg_consistency < consThr || sim_cycles > 20)
     	    	{
     	    		cout << " *** SIMULATION ENDED AT CYCLE:\t" << sim_cycles << endl;
     	    		delete in;
@@ -576,68 +584,6 @@ void statistics::handleMessage(cMessage *in)
 		}
 		else		// NOT TTL-based scenario. Delete msg and end simulation.
 		{
-
-			// *** Link Load Evaluation ***
-			int nextNode;
-			double currentBitPerSec;
-			double currentChLoad;
-			if(cores[0]->llEval)
-			{
-				for(int j=0; j<num_nodes; j++)
-				{
-					if(j==0)
-					{
-						for(int i=0; i < cores[j]->gateSize("face$o") - 1; i++)
-						{
-							nextNode = cores[j]->getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 1)
-							{
-								cout << "CAT CARD from CORE = " << cores[0]->catCard << endl;
-								for(long k=0; k < cores[0]->catCard; k++)
-								{
-									currentBitPerSec = cores[j]->numBits[i][k]/(SIMTIME_DBL(simTime())-stabilization_time);
-									currentChLoad = currentBitPerSec/cores[j]->datarate;
-									cout << "TIER 1 - Content # " << k+1 << "\tLOAD - " << currentChLoad << endl;
-								}
-							}
-						}
-
-					}
-					else if(j==1)
-					{
-						for(int i=0; i < cores[j]->gateSize("face$o") - 1; i++)
-						{
-							nextNode = cores[j]->getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 3)
-							{
-								for(long k=0; k<cores[0]->catCard; k++)
-								{
-									currentBitPerSec = cores[j]->numBits[i][k]/(SIMTIME_DBL(simTime())-stabilization_time);
-									currentChLoad = currentBitPerSec/cores[j]->datarate;
-									cout << "TIER 2 - Content # " << k+1 << "\tLOAD - " << currentChLoad << endl;
-								}
-							}
-						}
-					}
-					else if(j==3)
-					{
-						for(int i=0; i < cores[j]->gateSize("face$o") - 1; i++)
-						{
-							nextNode = cores[j]->getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-							if(nextNode == 7)
-							{
-								for(long k=0; k<cores[0]->catCard; k++)
-								{
-									currentBitPerSec = cores[j]->numBits[i][k]/(SIMTIME_DBL(simTime())-stabilization_time);
-									currentChLoad = currentBitPerSec/cores[j]->datarate;
-									cout << "TIER 3 - Content # " << k+1 << "\tLOAD - " << currentChLoad << endl;
-								}
-							}
-						}
-					}
-				}
-			}
-
 			delete in;
 			endSimulation();
 		}
@@ -715,8 +661,6 @@ bool statistics::stable(int n)
 // Print statistics.
 void statistics::finish()
 {
-	char name[30];
-
     uint32_t global_hit = 0;
     uint32_t global_miss = 0;
     uint32_t global_interests = 0;
@@ -726,6 +670,11 @@ void statistics::finish()
     uint32_t global_repo_load = 0;
 	long total_cost = 0;
 
+	// Interests aggregated inside the PITs and forwarded upstream after a PIT lookup.
+	double global_aggregated = 0;
+	double global_pit_forwarded = 0;
+	double global_saved_chunks = 0;
+
     double global_avg_distance = 0;
     simtime_t global_avg_time = 0;
     uint32_t global_tot_downloads = 0;
@@ -740,6 +689,11 @@ void statistics::finish()
     	//TODO: do not always compute cost. Do it only when you want to evaluate the cost in your network
 		total_cost += cores[i]->repo_load * cores[i]->get_repo_price();
 
+		for (unsigned f = 0; f < cores[i]->pit_faces.size(); f++)
+			global_aggregated += cores[i]->pit_faces[f].aggregated;
+		global_pit_forwarded += cores[i]->pit_forwarded;
+		global_saved_chunks += cores[i]->pit_saved_chunks;
+
 		if (cores[i]->interests)	// Check if the considered node has received Interest packets.
 		{
 			active_nodes++;
@@ -774,19 +728,24 @@ void statistics::finish()
     // Print and store global statistics
 
     // The global_hit is the mean hit rate among all the caches.
-    sprintf (name, "p_hit");
-    //recordScalar(name,global_hit * 1./(global_hit+global_miss));
-    recordScalar(name,global_hit_ratio * 1./active_nodes);
+    //record_global("p_hit",global_hit * 1./(global_hit+global_miss));
+    record_global("p_hit",global_hit_ratio * 1./active_nodes);
     //cout<<"p_hit/cache: "<<global_hit *1./(global_hit+global_miss)<<endl;
     cout<<"p_hit/cache: "<<global_hit_ratio * 1./active_nodes<<endl;
 
     // Mean number of received Interest packets per node.
-    sprintf ( name, "interests");
-    recordScalar(name,global_interests * 1./num_nodes);
+    record_global("interests",global_interests * 1./num_nodes);
 
     // Mean number of received Data packets per node.
-    sprintf ( name, "data" );
-    recordScalar(name,global_data * 1./num_nodes);
+    record_global("data",global_data * 1./num_nodes);
+
+    // Upstream traffic saved by Interest aggregation: fraction of the Interests missing in the
+    // caches that have not been forwarded, and chunks not requested upstream.
+    double agg_saved = (global_aggregated + global_pit_forwarded) > 0 ?
+    		global_aggregated / (global_aggregated + global_pit_forwarded) : 0;
+    record_global("agg_saved", agg_saved);
+    record_global("agg_saved_chunks", global_saved_chunks);
+    cout<<"Interests saved by aggregation: "<<agg_saved<<" ("<<global_saved_chunks<<" chunks)"<<endl;
 
     vector<double> global_scheduledReq;
     vector<double> global_validatedReq;
@@ -828,13 +787,11 @@ void statistics::finish()
 	}
 
     // Mean hit distance.
-    sprintf ( name, "hdistance");
-    recordScalar(name,global_avg_distance * 1./num_clients);
+    record_global("hdistance",global_avg_distance * 1./num_clients);
     cout<<"Distance/client: "<<global_avg_distance * 1./num_clients<<endl;
 
     // Mean download time.
-    sprintf ( name, "avg_time");
-    recordScalar(name,global_avg_time * 1./num_clients);
+    record_global("avg_time",SIMTIME_DBL(global_avg_time) * 1./num_clients);
     cout<<"Time/client: "<<global_avg_time * 1./num_clients<<endl;
 
     // SNM statistics
@@ -842,43 +799,28 @@ void statistics::finish()
     {
     	for(int j=0; j<snmPointer->numOfClasses; j++)
     	{
-    		sprintf(name, "Scheduled_requests_Class_%d", j+1);		// Absolute number of scheduled requests for that class.
-    		recordScalar(name, global_scheduledReq[j]);
-
-    		sprintf(name, "Scheduled_requests_perc_Class_%d", j+1);		// Percentage of scheduled requests.
-    		recordScalar(name, global_scheduledReq[j] * 1./snmPointer->totalRequests);
-
-    		sprintf(name, "Validated_requests_Class_%d", j+1);		// Absolute number of validated requests for that class.
-    		recordScalar(name, global_validatedReq[j]);
-
-    		sprintf(name, "Validated_requests_relative_perc_Class_%d", j+1);		// Relative percentage of validated requests.
-    		recordScalar(name, global_validatedReq[j] * 1./global_scheduledReq[j]);
-
-       		sprintf(name, "Validated_requests_abslute_perc_Class_%d", j+1);		// Absolute percentage of validated requests.
-        	recordScalar(name, global_validatedReq[j] * 1./snmPointer->totalRequests);
-
-    		sprintf(name, "Suppressed_requests_Class_%d", j+1);
-    		recordScalar(name, global_scheduledReq[j]-global_validatedReq[j]);
+    		record_class(j, "Scheduled_requests", global_scheduledReq[j]);		// Absolute number of scheduled requests for that class.
+    		record_class(j, "Scheduled_requests_perc", global_scheduledReq[j] * 1./snmPointer->totalRequests);		// Percentage of scheduled requests.
+    		record_class(j, "Validated_requests", global_validatedReq[j]);		// Absolute number of validated requests for that class.
+    		record_class(j, "Validated_requests_relative_perc", global_validatedReq[j] * 1./global_scheduledReq[j]);		// Relative percentage of validated requests.
+    		record_class(j, "Validated_requests_abslute_perc", global_validatedReq[j] * 1./snmPointer->totalRequests);		// Absolute percentage of validated requests.
+    		record_class(j, "Suppressed_requests", global_scheduledReq[j]-global_validatedReq[j]);
     	}
     }
 
 	// Total number of completed downloads (sum over all clients).
-    sprintf ( name, "downloads");
-    recordScalar(name,global_tot_downloads);
+    record_global("downloads",global_tot_downloads);
 
-    sprintf ( name, "total_cost");
-    recordScalar(name,total_cost);
+    record_global("total_cost",total_cost);
     cout<<"total_cost: "<<total_cost<<endl;
 
 
-    sprintf ( name, "total_replicas");
-    recordScalar(name,total_replicas);
+    record_global("total_replicas",total_replicas);
     cout<<"total_replicas: "<<total_replicas<<endl;
 
     // It is the fraction of traffic that is satisfied by some cache inside
     // the network, and thus does not exit the network
-    sprintf (name, "inner_hit");
-    recordScalar(name , (double) (global_tot_downloads - global_repo_load) / global_tot_downloads) ;
+    record_global("inner_hit", (double) (global_tot_downloads - global_repo_load) / global_tot_downloads) ;
 
     #ifdef SEVERE_DEBUG
 	if (global_tot_downloads == 0)
@@ -888,8 +830,7 @@ void statistics::finish()
 		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 	}
 
-		sprintf ( name, "interests_sent");
-		recordScalar(name,global_interests_sent);
+		record_global("interests_sent",global_interests_sent);
 		cout<<"interests_sent: "<<global_interests_sent<<endl;
 
 		if (global_interests_sent != global_tot_downloads){
@@ -912,11 +853,106 @@ void statistics::finish()
     //     hit_per_fileV.recordWithTimestamp(f, hit_rate);
     //}
 
+	// Accuracy of TTL-based (ModelGraft) runs: the run is accurate if it stabilized (CV criterion) and, with a dynamic Tc,
+	// if it passed the consistency check on the cache sizes (the Tc correction stops anyway after 20 cycles).
+	// The "MODELGRAFT CHECK" line is used by the scripts that select Delta automatically.
+	if(dynamic_cast<ttl_cache*>(caches[0]))
+	{
+		bool passed = mg_stable && (dynamic_tc ? (mg_consistency >= 0 && mg_consistency < consThr) : true);
+		record_global("modelgraft_delta", downsize);
+		record_global("modelgraft_cycles", sim_cycles);
+		record_global("modelgraft_consistency", mg_consistency);
+		record_global("modelgraft_passed", passed);
+		cout << "MODELGRAFT CHECK - Delta: " << downsize << " Consistency: " << mg_consistency
+			 << " Cycles: " << sim_cycles << " Stable: " << mg_stable << " Result: " << (passed ? "PASSED" : "FAILED") << endl;
+	}
+
+	// The results file will be written once all the modules have recorded their metrics.
+	results_pending = results_sink::get().is_open();
+
 	delete [] caches;
 	delete [] cores;
 	delete [] clients;
 }
 
+/*
+ * 	Global metrics are always recorded as scalars (the post-processing scripts look for them
+ * 	inside the .sca files), and also inside the "global" table of the results sink, if enabled.
+ */
+void statistics::record_global(const char *metric, double value)
+{
+	recordScalar(metric, value);
+	results_sink &sink = results_sink::get();
+	if (sink.is_open())
+		sink.record("global", 0, metric, value);
+}
+
+// Per-class metrics of the Shot Noise Model (e.g., "Scheduled_requests_Class_1").
+void statistics::record_class(int class_idx, const char *metric, double value)
+{
+	std::stringstream name;
+	name << metric << "_Class_" << class_idx+1;
+	recordScalar(name.str().c_str(), value);
+	results_sink &sink = results_sink::get();
+	if (sink.is_open())
+		sink.record("class", class_idx, metric, value);
+}
+
+/*
+ * 	Enable the binary results sink for the current run, and store the attributes
+ * 	needed to identify the run when repetitions are merged.
+ *
+ * 	Parameters:
+ * 		- file_name: output file of the current run.
+ */
+void statistics::open_results_sink(string file_name)
+{
+	// A wrong path is reported now rather than at the end of the run.
+	ofstream probe(file_name.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!probe)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Impossible to create the results file "<<file_name;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	probe.close();
+
+	results_sink &sink = results_sink::get();
+	sink.open(file_name);
+
+	#if OMNETPP_VERSION < 0x0500
+		cConfigurationEx *cfg = ev.getConfigEx();
+	#else
+		cConfigurationEx *cfg = getEnvir()->getConfigEx();
+	#endif
+	const char *vars[] = {"configname", "runnumber", "repetition", "seedset", "network"};
+	for (unsigned int i = 0; i < sizeof(vars)/sizeof(vars[0]); i++)
+	{
+		const char *value = cfg->getVariable(vars[i]);
+		if (value)
+			sink.set_attribute(vars[i], value);
+	}
+
+	std::stringstream value;
+	value << num_nodes;
+	sink.set_attribute("num_nodes", value.str());
+	value.str("");
+	value << num_clients;
+	sink.set_attribute("num_clients", value.str());
+}
+
+/*
+ * 	The results file is written only once all the modules have finished (the order in which
+ * 	modules finish is not defined), i.e., when the network is deleted.
+ */
+statistics::~statistics()
+{
+	if (results_pending)
+		results_sink::get().write();
+	else
+		results_sink::get().close();
+}
+
 void statistics::clear_stat()
 {
 	for (int i = 0;i<num_clients;i++)
@@ -931,9 +967,7 @@ void statistics::clear_stat()
 }
 
 void statistics::stability_has_been_reached(){
-	char name[30];
-	sprintf (name, "stabilization_time");
-	recordScalar(name,stabilization_time);
+	record_global("stabilization_time",stabilization_time);
 	cout<<"stabilization_time: "<< stabilization_time <<endl;
 
 	clear_stat();
@@ -1227,7 +1261,6 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	cout << "Model CACHE SIZE = " << cSize_targ << endl;
 
 	double alphaVal = content_distribution::zipf[0]->get_alpha();
-	double normConstant = content_distribution::zipf[0]->get_normalization_constant();  // Zipf's normalization constant.
 
 	string forwStr = caches[0]->getParentModule()->par("FS");
 	cout << "*** Model Forwarding Strategy : " << forwStr << " ***" << endl;
@@ -1251,6 +1284,27 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			dpString = "fixP";
 			cout << "*** fixP *** Decision Policy with q = " << q << endl;
 		}
+		else if(dynamic_cast<Two_Lru*> (decisor))
+		{
+			// 2-LRU is a q-LRU whose q is the hit probability of the (LRU) name cache.
+			meta_cache = twoLRU;
+			nc_size = (int)caches[0]->par("NC");
+			if(nc_size == 0)
+			{
+				std::stringstream ermsg;
+				ermsg<<"2-LRU model requires a name cache (NC > 0). Please check.";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			dpString = "2-LRU";
+			cout << "*** 2-LRU *** Decision Policy with name cache size = " << nc_size << endl;
+		}
+		else if(dynamic_cast<LCD*> (decisor))
+		{
+			// LCD is a q-LRU whose q is the hit probability of the upstream cache.
+			meta_cache = leaveCopyDown;
+			dpString = "LCD";
+			cout << "*** LCD *** Decision Policy!" << endl;
+		}
 		else
 		{
 			cout << "Decision policy not supported!" << endl;
@@ -1258,6 +1312,15 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 		}
 	}
 
+	// Exogenous request rates (IRM, or ON/OFF processes of the Shot Noise Model).
+	model_request_rates(M, Lambda);
+	if(onoff_model && meta_cache != LCE)
+	{
+		std::stringstream ermsg;
+		ermsg<<"With Shot Noise workloads, the model supports only the LCE meta-caching. Please check.";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
 	cout << "***** CACHE FILLING WITH MODEL *****" << endl;
 
 	// Definition and initialization of useful data structures.
@@ -1281,6 +1344,10 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	}
 
 	double *tc_vect = new double[N]; 		// Vector containing the 'characteristic times' of each node.
+	double *tc_name_vect = new double[N];	// Tc of the name cache of each node (2-LRU).
+	fill_n(tc_name_vect,N,0.0);
+	float *q_vect = new float[M];			// Per-content insertion probability at the current node (2-LRU and LCD).
+	vector<int> upstream(N,-1);				// Next hop of each node towards the repository (-1 for the repository).
 
 
 	/*double **p_in_temp;				// Temp vector to find the max p_in per each node at the end of each iteration.
@@ -1319,15 +1386,13 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	// As a consequence, the characteristic times of all the nodes will be initially the same, and so the Pin.
 
 	int step = 0;
-	double num = 0;
 	bool climax;
 
 	cout << "Iteration # " << step << " - INITIALIZATION" << endl;
 
 	for (long m=0; m < M; m++)
 	{
-		num = (1.0/pow(m+1,alphaVal));
-		prev_rate[0][m] = (float)(num*normConstant)*Lambda;
+		prev_rate[0][m] = (float)exo_rate[m];
 		sumCurrRate[0] += prev_rate[0][m];
 	}
 
@@ -1341,11 +1406,29 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	// The Tc will be initially the same for all the nodes, so we pass just the first column of the prev_rate.
 	// In the following steps it will be Tc_val(n) = compute_Tc(...,prev_rate, n-1).
 
-	double tc_val = compute_Tc_single_Approx(cSize_targ, alphaVal, M, prev_rate, 0, dpString, q);
+	double tc_val;
+	if(onoff_model)
+		tc_val = compute_Tc_single_OnOff(cSize_targ, M, prev_rate, 0, on_mu, on_toff);
+	else
+		tc_val = compute_Tc_single_Approx(cSize_targ, alphaVal, M, prev_rate, 0, (meta_cache == fixP) ? dpString : "LCE", q);
 
 	cout << "Computed Tc during initialization:\t" << tc_val << endl;
 
-	if(meta_cache == LCE)
+	if(onoff_model)
+	{
+		for (int n=0; n < N; n++)
+		{
+			tc_vect[n] = tc_val;
+			for (long m=0; m < M; m++)
+			{
+				p_in[n][m] = onoff_pin(prev_rate[n][m], tc_vect[n], on_mu[m], on_toff[m]);
+				p_hit[n][m] = onoff_phit(prev_rate[n][m], tc_vect[n], on_mu[m], on_toff[m]);
+			}
+			pHitNode[n] = model_node_phit(prev_rate[n], p_hit[n], M);
+			prev_pHitTot += pHitNode[n];
+		}
+	}
+	else if(meta_cache == LCE)
 	{
 		for (int n=0; n < N; n++)
 		{
@@ -1374,6 +1457,22 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			prev_pHitTot += pHitNode[n];
 		}
 	}
+	else if (meta_cache == twoLRU || meta_cache == leaveCopyDown)
+	{
+		// The upstream caches are not known yet, so that LCD starts as LCE (q = 1).
+		for (int n=0; n < N; n++)
+		{
+			tc_name_vect[n] = model_insertion_prob(n, prev_rate, p_in, upstream, M, q_vect);
+			tc_vect[n] = compute_Tc_single_Approx_qVect(cSize_targ, M, prev_rate, n, q_vect);
+			for (long m=0; m < M; m++)
+			{
+				p_in[n][m] = qlru_pin(prev_rate[n][m], tc_vect[n], q_vect[m]);
+				p_hit[n][m] = p_in[n][m];
+				pHitNode[n] += (prev_rate[n][m]/sumCurrRate[n])*p_hit[n][m];
+			}
+			prev_pHitTot += pHitNode[n];
+		}
+	}
 	else
 	{
 		cout << "Meta Caching Algorithm NOT Implemented!" << endl;
@@ -1457,6 +1556,8 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 				outInt = cores[n]->getOutInt(*itRepoVect);
 				target = caches[n]->getParentModule()->gate("face$o",outInt)->getNextGate()->getOwnerModule()->getIndex();
 				neighMatrix[target].insert( pair<int,int>(n,1));
+				if (upstream[n] == -1)
+					upstream[n] = target;
 			}
 		}
 	}
@@ -1493,7 +1594,9 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			    		int neigh = it->first;
 			    		int numPot = it->second;    // number of potential targets for the neighbor
 
-			    		if(meta_cache == LCE)
+			    		if(onoff_model)
+			    			p_hit[neigh][m] = onoff_phit(prev_rate[neigh][m], tc_vect[neigh], on_mu[m], on_toff[m]);
+			    		else if(meta_cache == LCE)
 			    		{
 			    			if(prev_rate[neigh][m]*tc_vect[neigh] <= 0.01)
 			    				p_hit[neigh][m] = prev_rate[neigh][m]*tc_vect[neigh];
@@ -1507,6 +1610,8 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			    			else
 			    				p_hit[neigh][m] = calculate_phit_neigh_scalable(neigh, m, prev_rate, p_in, p_hit, tc_vect, alphaVal, Lambda, M, clientVector, neighMatrix);
 			    		}
+			    		else if(meta_cache == twoLRU || meta_cache == leaveCopyDown)
+			    			p_hit[neigh][m] = p_in[neigh][m];		// Che's approximation (IRM): Phit = Pin.
 			    		else
 						{
 							cout << "Meta Caching Algorithm NOT Implemented!" << endl;
@@ -1526,10 +1631,7 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 
 
 			    if (clientVector[n])	// In case a client is attached to the current node.
-		    	{
-					num = (1.0/(double)pow(m+1,alphaVal));
-					neigh_rate += (num*normConstant)*Lambda;
-		    	}
+					neigh_rate += exo_rate[m];
 
 			    curr_rate[n][m] = neigh_rate;
 
@@ -1550,10 +1652,23 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 										// other nodes (or by both)
 			{
 				cout << "NODE # " << n << " Sum Current Rate: " << sumCurrRate[n] << endl;
-				tc_vect[n] = compute_Tc_single_Approx(cSize_targ, alphaVal, M, curr_rate, n, dpString, q);
+				if(onoff_model)
+					tc_vect[n] = compute_Tc_single_OnOff(cSize_targ, M, curr_rate, n, on_mu, on_toff);
+				else if(meta_cache == twoLRU || meta_cache == leaveCopyDown)
+				{
+					tc_name_vect[n] = model_insertion_prob(n, curr_rate, p_in, upstream, M, q_vect);
+					tc_vect[n] = compute_Tc_single_Approx_qVect(cSize_targ, M, curr_rate, n, q_vect);
+				}
+				else
+					tc_vect[n] = compute_Tc_single_Approx(cSize_targ, alphaVal, M, curr_rate, n, dpString, q);
 
 				cout << "Node # " << n << " - Tc " << tc_vect[n] << endl;
-				if(meta_cache == LCE)
+				if(onoff_model)
+				{
+					for(long m=0; m < M; m++)
+						p_in[n][m] = onoff_pin(curr_rate[n][m], tc_vect[n], on_mu[m], on_toff[m]);
+				}
+				else if(meta_cache == LCE)
 				{
 					for(long m=0; m < M; m++)
 					{
@@ -1613,6 +1728,11 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 					}
 					climax = false;
 				}
+				else if(meta_cache == twoLRU || meta_cache == leaveCopyDown)
+				{
+					for(long m=0; m < M; m++)
+						p_in[n][m] = qlru_pin(curr_rate[n][m], tc_vect[n], q_vect[m]);
+				}
 				else
 				{
 					cout << "Meta Caching Algorithm NOT Implemented!" << endl;
@@ -1627,7 +1747,9 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 				{
 					for(long m=0; m < M; m++)
 					{
-						if(meta_cache == LCE)
+						if(onoff_model)
+							p_hit[n][m] = onoff_phit(curr_rate[n][m], tc_vect[n], on_mu[m], on_toff[m]);
+						else if(meta_cache == LCE)
 						{
 							if(curr_rate[n][m]*tc_vect[n] <= 0.01)
 								p_hit[n][m] = curr_rate[n][m]*tc_vect[n];
@@ -1641,6 +1763,8 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 							else
 								p_hit[n][m] = calculate_phit_neigh_scalable(n, m, curr_rate, p_in, p_hit, tc_vect, alphaVal, Lambda, M, clientVector, neighMatrix);
 						}
+						else if(meta_cache == twoLRU || meta_cache == leaveCopyDown)
+							p_hit[n][m] = p_in[n][m];
 						else
 						{
 							cout << "Meta Caching Algorithm NOT Implemented!" << endl;
@@ -1670,10 +1794,7 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			pHitNode[n] = 0;
 			if(sumCurrRate[n]!=0)
 			{
-				for (long m=0; m < M; m++)
-				{
-					pHitNode[n] += (curr_rate[n][m]/sumCurrRate[n])*p_hit[n][m];
-				}
+				pHitNode[n] = model_node_phit(curr_rate[n], p_hit[n], M);
 				curr_pHitTot += pHitNode[n];
 			}
 
@@ -1716,10 +1837,7 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			activeNodes.push_back(n);
 
 			// Calculate di p_hit mean of the node
-			for(uint32_t m=0; m < M; m++)
-			{
-				pHitNodeMean += (curr_rate[n][m]/sumCurrRate[n])*p_hit[n][m];
-			}
+			pHitNodeMean = model_node_phit(curr_rate[n], p_hit[n], M);
 
 			// *** DISABLED for perf measurements
 			if(!onlyModel)
@@ -1771,6 +1889,8 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	for(int n=0; n < N; n++)
 	{
 		cout << "Tc-" << n << " --> " << tc_vect[n] << endl;
+		if(meta_cache == twoLRU)
+			cout << "Tc name cache-" << n << " --> " << tc_name_vect[n] << endl;
 	}
 
     // *** DISABLED per perf evaluation
@@ -1804,6 +1924,29 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 				// Empty the cache from the previous step.
 				caches[node_id]->flush();
 
+				// With 2-LRU, the name cache is filled as well, with the NC IDs having the highest request rate
+				// (i.e., the highest hit probability inside an LRU name cache). The most popular is inserted last (MRU).
+				if(meta_cache == twoLRU)
+				{
+					Two_Lru* tLruPointer = dynamic_cast<Two_Lru *> (decisor);
+					vector<long> ids(M);
+					for (long m=0; m < M; m++)
+						ids[m] = m;
+					long nc_fill = min((long)nc_size, M);
+					float *rates = prev_rate[node_id];
+					partial_sort(ids.begin(), ids.begin() + nc_fill, ids.end(), [rates](long a, long b){return rates[a] > rates[b];});
+					for (long k=nc_fill-1; k >= 0; k--)
+					{
+						if (rates[ids[k]] == 0)
+							continue;
+						cont_id = (uint32_t)ids[k]+1;
+						chunk_t chunk = 0;
+						__sid(chunk, cont_id);
+						__schunk(chunk, 0);
+						tLruPointer->name_to_cache(chunk);
+					}
+				}
+
 				//for (int k=cSize_targ-1; k >= 0; k--)   // Start inserting contents with the smallest p_in.
 				for (unsigned int k=0; k < cSize_targ; k++)
 				{
@@ -1815,7 +1958,7 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 					__schunk(chunk, 0);
 					//ccn_data* data = new ccn_data("data",CCN_D);
 					data -> setChunk (chunk);
-					data -> setHops(0);
+					data -> setHops(meta_cache == leaveCopyDown ? 1 : 0);		// LCD only caches Data coming from one hop away.
 					data->setTimestamp(simTime());
 					caches[node_id]->store(data);
 				}
@@ -1953,6 +2096,14 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	delete [] curr_rate;
 	delete [] p_in;
 	delete [] p_hit;
+	delete [] tc_name_vect;
+	delete [] q_vect;
+	delete [] exo_rate;
+	delete [] on_mu;
+	delete [] on_toff;
+	delete [] on_duty;
+	exo_rate = NULL;
+	on_mu = on_toff = on_duty = NULL;
 
 }
 
@@ -2099,6 +2250,110 @@ double statistics::calculate_phit_neigh_scalable(int node_ID, int cont_ID, float
 }
 
 
+/*
+ * 	Request model of the analytical engine. For each content (at a node with an attached client):
+ * 		- exo_rate: exogenous request rate (during ON periods);
+ * 		- on_mu, on_toff, on_duty: inverse of the mean ON period, OFF period, and fraction of time spent ON.
+ *
+ * 	With IRM, the single Zipf of the catalog is used and contents are always ON (on_mu = 0). With the Shot Noise
+ * 	Model, each class has its own Zipf (over its contents) and per-client rate; requests for a content are
+ * 	Poisson during its ON periods (Exp, mean Ton) and suppressed during its OFF periods (Toff = k*Ton). Classes
+ * 	whose Ton exceeds the simulated time are always ON, as in client_ShotNoise.
+ */
+void statistics::model_request_rates(long catCard, double lambdaVal)
+{
+	delete [] exo_rate;
+	delete [] on_mu;
+	delete [] on_toff;
+	delete [] on_duty;
+	exo_rate = new double[catCard];
+	on_mu = new float[catCard];
+	on_toff = new float[catCard];
+	on_duty = new float[catCard];
+	fill_n(on_mu, catCard, 0);
+	fill_n(on_toff, catCard, 0);
+	fill_n(on_duty, catCard, 1);
+
+	ShotNoiseContentDistribution* snm = dynamic_cast<ShotNoiseContentDistribution*>(getParentModule()->getSubmodule("content_distribution"));
+	onoff_model = (snm != NULL);
+
+	if(!onoff_model)
+	{
+		double alphaVal = content_distribution::zipf[0]->get_alpha();
+		double normConstant = content_distribution::zipf[0]->get_normalization_constant();
+		for(long m=0; m < catCard; m++)
+			exo_rate[m] = (1.0/pow(m+1,alphaVal))*normConstant*lambdaVal;
+		return;
+	}
+
+	cout << "*** Model with Shot Noise request processes (" << snm->numOfClasses << " classes) ***" << endl;
+	for(int c=0; c < snm->numOfClasses; c++)
+	{
+		ShotNoiseContentDistribution::classInfoEntry &cl = snm->classInfo->operator [](c);
+		long first = cl.mostPopular - 1;
+		long last = min((long)cl.lessPopular, catCard);
+
+		double norm = 0;
+		for(long m=first; m < last; m++)
+			norm += pow(m-first+1, -cl.classAlpha);
+
+		bool onOff = cl.ton < snm->steadySimTime;
+		double ton = SIMTIME_DBL(cl.ton);
+		double toff = SIMTIME_DBL(cl.toff);
+		for(long m=first; m < last; m++)
+		{
+			exo_rate[m] = cl.lambdaClient * pow(m-first+1, -cl.classAlpha) / norm;
+			if(onOff && toff > 0)
+			{
+				on_mu[m] = 1./ton;
+				on_toff[m] = toff;
+				on_duty[m] = ton / (ton + toff);
+			}
+		}
+	}
+}
+
+/*
+ * 	Hit probability of a node, i.e., the average of the per-content hit probabilities weighted by the
+ * 	mean request rates (the ON rate times the duty cycle).
+ */
+double statistics::model_node_phit(float *rates, float *Phit, long catCard)
+{
+	double weighted = 0, total = 0;
+	for(long m=0; m < catCard; m++)
+	{
+		double r = rates[m]*on_duty[m];
+		weighted += r*Phit[m];
+		total += r;
+	}
+	return (total > 0) ? weighted/total : 0;
+}
+
+/*
+ * 	Per-content insertion probability 'qVect' of node 'node_ID' for the meta-caching algorithms modeled as a q-LRU
+ * 	with a per-content q:
+ * 		- 2-LRU: q is the hit probability of the name cache (LRU of nc_size IDs, which sees all the requests of
+ * 		  the node); the Tc of the name cache is returned;
+ * 		- LCD: q is the hit probability (Pin, under IRM) of the upstream cache, i.e., the probability that the
+ * 		  Data comes from one hop away; it is 1 at the repository node, which always caches what its repo serves.
+ */
+double statistics::model_insertion_prob(int node_ID, float **rates, float **Pin, vector<int> &upstream, long catCard, float *qVect)
+{
+	if(meta_cache == twoLRU)
+	{
+		double tcName = compute_Tc_single_Approx(nc_size, 0, catCard, rates, node_ID, "LCE", 0);
+		for(long m=0; m < catCard; m++)
+			qVect[m] = qlru_pin(rates[node_ID][m], tcName, 1.0);
+		return tcName;
+	}
+
+	int up = upstream[node_ID];
+	for(long m=0; m < catCard; m++)
+		qVect[m] = (up == -1) ? 1.0 : Pin[up][m];
+	return 0;
+}
+
+
 // *** APPROX NRR ***
 
 
@@ -2142,7 +2397,7 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 		}
 		else
 		{
-			cout << "Decision policy not supported!" << endl;
+			cout << "Decision policy not supported! (2-LRU and LCD are modeled only with a single repository)" << endl;
 			exit(0);
 		}
 	}
@@ -2388,8 +2643,7 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 					//	caches[n]->dump();
 					strategy_layer* strategy_ptr = cores[n]->get_strategy();
 					int nOutInt = strategy_ptr->__get_outer_interfaces();
-					bool *outInterfaces = new bool [nOutInt];
-					fill_n(outInterfaces, nOutInt, false);
+					interface_t outInterfaces = 0;
 
 					for (int m=0; m < M; m++)
 					{
@@ -2400,22 +2654,20 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 						//if (itRepoVect != repoVector[m].end() && *itRepoVect != n)
 						else
 						{
-							// Reset the vector representing the out interfaces
-							fill_n(outInterfaces, nOutInt, false);
 							numPotTargets = 0;
 
 							outInterfaces = strategy_ptr->exploit_model(m);  // Lookup inside network caches
 
 							for (int p=0; p < nOutInt; p++)			// Count the number of potential targets.
 							{
-								if(outInterfaces[p])
+								if(__face(outInterfaces, p))
 									numPotTargets++;
 							}
 
 
 							for (int p=0; p < nOutInt; p++)  	// Fill the neighMatrix for the selected target.
 							{
-								if(outInterfaces[p])
+								if(__face(outInterfaces, p))
 								{
 									target = caches[n]->getParentModule()->gate("face$o",p)->getNextGate()->getOwnerModule()->getIndex();
 									neighMatrix[target][m].insert( pair<int,int>(n,numPotTargets));